@@ -26,7 +26,7 @@ namespace QCreate
 
 		static ImGuiTableFlags tableFlags = ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Sortable;
 
-		const AllocatorVector& allocators = MemoryManager::GetInstance().GetAllocators();
+		const AllocatorVector allocators = MemoryManager::GetInstance().GetAllocators();
 		const Size totalBudget = MemoryManager::GetInstance().GetApplicationMemoryBudget();
 		const Size totalAllocated = MemoryManager::GetInstance().GetTotalAllocatedSize();
 
@@ -34,6 +34,10 @@ namespace QCreate
 		ImGui::SameLine();
 		ImGui::Text("%s/%s", QMBT::Utility::ToReadable(totalAllocated).c_str(), QMBT::Utility::ToReadable(totalBudget).c_str());
 
+		ImGui::Text("Committed Memory: ");
+		ImGui::SameLine();
+		ImGui::Text("%s/%s", QMBT::Utility::ToReadable(MemoryManager::GetInstance().GetCommittedAllocatedSize()).c_str(), QMBT::Utility::ToReadable(totalAllocated).c_str());
+
 		ImVec2 cursorPos = ImGui::GetCursorScreenPos();
 		float totalWidth = ImGui::GetContentRegionAvail().x;
 		float bottomEdge = cursorPos.y + m_BarHeight;
@@ -64,21 +68,84 @@ namespace QCreate
 			bool open = ImGui::TreeNodeEx(allocator->DebugName, treeNodeFlags);
 			if (open)
 			{
+				const Size usedSize = allocator->UsedSize.load(std::memory_order_relaxed);
+
 				ImGui::Text("Memory Usage: ");
 				ImGui::SameLine();
-				ImGui::Text("%s/%s", QMBT::Utility::ToReadable(allocator->UsedSize).c_str(), QMBT::Utility::ToReadable(allocator->TotalSize).c_str());
+				ImGui::Text("%s/%s", QMBT::Utility::ToReadable(usedSize).c_str(), QMBT::Utility::ToReadable(allocator->TotalSize).c_str());
+
+				ImGui::Text("Committed: ");
+				ImGui::SameLine();
+				ImGui::Text("%s/%s", QMBT::Utility::ToReadable(allocator->CommittedSize).c_str(), QMBT::Utility::ToReadable(allocator->TotalSize).c_str());
+
+				if (allocator->ReservedSize != 0)
+				{
+					ImGui::Text("Address Space: ");
+					ImGui::SameLine();
+					ImGui::Text("%s", QMBT::Utility::ToReadable(allocator->ReservedSize).c_str());
+				}
+
+				if (allocator->PeakUsedSize != 0)
+				{
+					ImGui::Text("High-Water Mark: ");
+					ImGui::SameLine();
+					ImGui::Text("%s", QMBT::Utility::ToReadable(allocator->PeakUsedSize).c_str());
+				}
+
+				if (allocator->LastPeakUsedSize != 0)
+				{
+					ImGui::Text("Last Frame Peak: ");
+					ImGui::SameLine();
+					ImGui::Text("%s", QMBT::Utility::ToReadable(allocator->LastPeakUsedSize).c_str());
+				}
+
+				if (allocator->HasFreeBlockStats)
+				{
+					ImGui::Text("Free Blocks: ");
+					ImGui::SameLine();
+					ImGui::Text("%zu, largest %s", allocator->FreeBlockCount, QMBT::Utility::ToReadable(allocator->LargestFreeBlock).c_str());
+
+					ImGui::Text("External Fragmentation: ");
+					ImGui::SameLine();
+					ImGui::Text("%.1f%%", allocator->GetExternalFragmentation() * 100.0f);
+
+					ImGui::Text("Overhead: ");
+					ImGui::SameLine();
+					ImGui::Text("%s", QMBT::Utility::ToReadable(allocator->OverheadSize).c_str());
+
+					// Number of free blocks per power of two size, up to the bucket of the largest one
+					float histogram[AllocatorData::FREE_BLOCK_HISTOGRAM_SIZE];
+					const Size bucketCount = AllocatorData::GetHistogramBucket(allocator->LargestFreeBlock) + 1;
+					for (Size bucket = 0; bucket < bucketCount; bucket++)
+					{
+						histogram[bucket] = static_cast<float>(allocator->FreeBlockHistogram[bucket]);
+					}
+					ImGui::PlotHistogram("Free Block Sizes", histogram, static_cast<int>(bucketCount), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, m_BarHeight * 2));
+				}
+
+				if (!allocator->PoolBlocks.empty())
+				{
+					// Share of the chunks in use, per block
+					std::vector<float> occupancy;
+					for (const AllocatorData::PoolBlock& block : allocator->PoolBlocks)
+					{
+						occupancy.push_back(static_cast<float>(block.UsedChunks) / static_cast<float>(block.ChunkCount));
+					}
+					ImGui::PlotHistogram("Block Occupancy", occupancy.data(), static_cast<int>(occupancy.size()), 0, nullptr, 0.0f, 1.0f, ImVec2(0, m_BarHeight * 2));
+				}
 
 				cursorPos = ImGui::GetCursorScreenPos();
 				totalWidth = ImGui::GetContentRegionAvail().x;
 				bottomEdge = cursorPos.y + m_BarHeight;
 
 				ImGuiHelper::DrawHoverableRect(cursorPos, ImVec2(cursorPos.x + totalWidth, bottomEdge), m_Colors.GetRandomColor(),
-											   "Available: %s", QMBT::Utility::ToReadable(allocator->TotalSize - allocator->UsedSize).c_str());
+											   "Available: %s", QMBT::Utility::ToReadable(allocator->TotalSize - usedSize).c_str());
 
-				float width = (static_cast<float>(allocator->UsedSize) / static_cast<float>(allocator->TotalSize)) * totalWidth;
+				// Arenas that commit as they grow have nothing in their total size while they are empty
+				float width = allocator->TotalSize == 0 ? 0.0f : (static_cast<float>(usedSize) / static_cast<float>(allocator->TotalSize)) * totalWidth;
 
 				ImGuiHelper::DrawHoverableRect(cursorPos, ImVec2(cursorPos.x + width, bottomEdge), m_Colors.GetRandomColor(),
-											   "Used: %s", QMBT::Utility::ToReadable(allocator->UsedSize).c_str());
+											   "Used: %s", QMBT::Utility::ToReadable(usedSize).c_str());
 
 				ImGui::SetCursorScreenPos(ImVec2(cursorPos.x, bottomEdge + ImGuiStyleVar_FramePadding));
 
@@ -89,15 +156,22 @@ namespace QCreate
 
 					ImGui::TableHeadersRow();
 
-					for (auto& allocation : allocator->Allocations)
+					const Size tagCount = AllocationTagRegistry::GetTagCount();
+					for (Size tag = AllocationTagRegistry::UNTAGGED + 1; tag < tagCount; tag++)
 					{
+						const Size allocatedSize = allocator->TaggedSizes[tag].load(std::memory_order_relaxed);
+						if (allocatedSize == 0)
+						{
+							continue;
+						}
+
 						ImGui::TableNextRow();
 
 						ImGui::TableSetColumnIndex(0);
-						ImGui::Text(allocation.first.c_str());
+						ImGui::Text(AllocationTagRegistry::GetName(static_cast<UInt16>(tag)));
 
 						ImGui::TableSetColumnIndex(1);
-						ImGui::Text(QMBT::Utility::ToReadable(allocation.second).c_str());
+						ImGui::Text(QMBT::Utility::ToReadable(allocatedSize).c_str());
 					}
 
 					ImGui::EndTable();
@@ -3,8 +3,21 @@
 #include "Core/Aliases.hpp"
 #include "Core/Configuration/Configuration.hpp"
 #include "Core/Logging/Logger.hpp"
+#include "Core/Memory/AllocationTracker.hpp"
+#include "Core/Memory/DoubleBufferedAllocator.hpp"
+#include "Core/Memory/FrameAllocator.hpp"
 #include "Core/Memory/FreeListAllocator.hpp"
+#include "Core/Memory/MemoryResource.hpp"
+#include "Core/Memory/PolicyAllocator.hpp"
 #include "Core/Memory/PoolAllocator.hpp"
 #include "Core/Memory/STLAllocator.hpp"
+#include "Core/Memory/ScratchArena.hpp"
+#include "Core/Memory/SmallObjectAllocator.hpp"
 #include "Core/Memory/StackAllocator.hpp"
+#include "Core/Memory/ThreadCachedAllocator.hpp"
 #include "Core/Memory/Utility/MemoryUtils.hpp"
+#include "Core/Memory/VirtualArena.hpp"
+#include "Core/Types/FixedHashMap.hpp"
+#include "Core/Types/FixedString.hpp"
+#include "Core/Types/FixedVector.hpp"
+#include "Core/Types/SlotMap.hpp"
@@ -4,7 +4,10 @@
 #include "Events/ApplicationEvent.hpp"
 #include "glad/glad.h"
 
+#include "Core/CoreConfig.hpp"
+#include "Core/Memory/AllocationTracker.hpp"
 #include "Core/Memory/STLAllocator.hpp"
+#include "Core/Memory/ThreadCachedAllocator.hpp"
 
 namespace QMBT
 {
@@ -24,6 +27,11 @@ namespace QMBT
 
 	Application::~Application()
 	{
+		// Whatever the layers and the window have not freed by now is reported as live
+		if (AllocationTracker::IsEnabled())
+		{
+			AllocationTracker::LogReport();
+		}
 	}
 
 	void Application::Run()
@@ -51,7 +59,12 @@ namespace QMBT
 				m_Window->OnUpdate();
 			}
 
+			GetGlobalAllocator()->ReleaseIdleRegions();
+
 			Instrumentor::GetInstance().EndFrame();
+
+			m_FrameAllocator.EndFrame();
+			m_DoubleBufferedAllocator.SwapBuffers();
 		}
 	}
 
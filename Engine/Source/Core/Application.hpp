@@ -4,7 +4,10 @@
 #include "Display/Window.hpp"
 
 #include "Core/LayerStack.hpp"
+#include "Core/Memory/DoubleBufferedAllocator.hpp"
+#include "Core/Memory/FrameAllocator.hpp"
 #include "Core/Memory/FreeListAllocator.hpp"
+#include "Core/Memory/MemoryResource.hpp"
 #include "Core/Memory/StackAllocator.hpp"
 #include "Core/Types/UniquePtr.hpp"
 #include "Events/ApplicationEvent.hpp"
@@ -40,6 +43,13 @@ namespace QMBT
 		inline static Application& Get() { return *s_Instance; }
 		inline Window& GetWindow() { return *m_Window; }
 
+		// For data that only lives until the end of the current frame
+		inline static FrameAllocator& GetFrameAllocator() { return s_Instance->m_FrameAllocator; }
+		// For containers that only live until the end of the current frame, passed to their STLAllocator
+		inline static MemoryResource* GetFrameResource() { return &s_Instance->m_FrameResource; }
+		// For data that is consumed in the frame after the one it is produced in
+		inline static DoubleBufferedAllocator& GetDoubleBufferedAllocator() { return s_Instance->m_DoubleBufferedAllocator; }
+
 		//inline static FreeListAllocator* GetFreeListAllocator() { return &(s_Instance->m_GlobalAllocator); }
 
 	  private:
@@ -52,6 +62,10 @@ namespace QMBT
 	  private:
 		static Application* s_Instance;
 
+		FrameAllocator m_FrameAllocator;
+		AllocatorResource<FrameAllocator> m_FrameResource{m_FrameAllocator};
+		DoubleBufferedAllocator m_DoubleBufferedAllocator;
+
 		UniquePtr<Window> m_Window;
 		LayerStack m_LayerStack;
 		//LayerStack m_EditorLayerStack;
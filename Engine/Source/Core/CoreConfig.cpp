@@ -1,19 +1,31 @@
 #include "CoreConfig.hpp"
-#include "Memory/FreeListAllocator.hpp"
 #include "Memory/STLAllocator.hpp"
+#include "Memory/SmallObjectAllocator.hpp"
+#include "Memory/ThreadCachedAllocator.hpp"
 
 namespace QMBT
 {
-	FreeListAllocator g_GlobalAllocator;
-	FreeListAllocator* g_GlobalAllocatorPtr = &g_GlobalAllocator;
+	// Starts small and grows on demand, giving regions and large free spans that go unused back to the OS
+	ThreadCachedAllocator g_GlobalAllocator("Global Allocator", 8_MB, FreeListAllocator::FIND_SEGREGATED, ResizePolicy::Resizable,
+											BackingPolicy::Pages);
+	ThreadCachedAllocator* g_GlobalAllocatorPtr = &g_GlobalAllocator;
+
+	// Defined after the global allocator, so it is constructed after and destroyed before it
+	SmallObjectAllocator g_SmallObjectAllocator(&g_GlobalAllocator);
+	SmallObjectAllocator* g_SmallObjectAllocatorPtr = &g_SmallObjectAllocator;
 
 	STLAllocator g_DefaultSTLAllocator;
 	STLAllocator* g_DefaultSTLAllocatorPtr = &g_DefaultSTLAllocator;
 
-	FreeListAllocator* GetGlobalAllocator()
+	ThreadCachedAllocator* GetGlobalAllocator()
 	{
 		return g_GlobalAllocatorPtr;
 	}
+
+	SmallObjectAllocator* GetSmallObjectAllocator()
+	{
+		return g_SmallObjectAllocatorPtr;
+	}
 } // namespace QMBT
 
 QMBT::STLAllocator* GetGlobalSTLAllocator()
@@ -4,9 +4,14 @@ namespace QMBT
 {
 	STLAllocator* GetDefaultGlobalAllocator();
 
-	class FreeListAllocator;
+	class ThreadCachedAllocator;
 
-	FreeListAllocator* GetGlobalAllocator();
+	ThreadCachedAllocator* GetGlobalAllocator();
+
+	class SmallObjectAllocator;
+
+	// Sends blocks of up to 256 bytes to size-class pools, and larger ones to the global allocator
+	SmallObjectAllocator* GetSmallObjectAllocator();
 
 } // namespace QMBT
 
@@ -2,7 +2,7 @@
 
 #include "Core/Aliases.hpp"
 #include "Core/Layer.hpp"
-#include "Core/Types/Vector.hpp"
+#include "Core/Types/FixedVector.hpp"
 
 namespace QMBT
 {
@@ -13,6 +13,10 @@ namespace QMBT
 	class LayerStack
 	{
 	  public:
+		// Applications rarely have more layers than this, so the stack does not allocate
+		static constexpr Size INLINE_LAYER_COUNT = 8;
+		using LayerVector = FixedVector<Layer*, INLINE_LAYER_COUNT>;
+
 		LayerStack();
 		~LayerStack();
 
@@ -43,15 +47,15 @@ namespace QMBT
 		 */
 		void PopOverlay(Layer* overlay);
 
-		Vector<Layer*>::iterator begin() { return m_Layers.begin(); }
-		Vector<Layer*>::iterator end() { return m_Layers.end(); }
+		LayerVector::iterator begin() { return m_Layers.begin(); }
+		LayerVector::iterator end() { return m_Layers.end(); }
 
-		//const Vector<Layer*>::iterator cbegin() { return m_Layers.cbegin(); }
-		//const Vector<Layer*>::iterator cend() { return m_Layers.cend(); }
+		//const LayerVector::iterator cbegin() { return m_Layers.cbegin(); }
+		//const LayerVector::iterator cend() { return m_Layers.cend(); }
 
 	  private:
 		//Stores all the layers and overlays
-		Vector<Layer*> m_Layers;
+		LayerVector m_Layers;
 		/*
 		Acts as the barrier between layers and overlays. Layers are stored in the first half
 		(before the insert), while overlays are stored after the insert.
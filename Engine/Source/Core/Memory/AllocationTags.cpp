@@ -0,0 +1,95 @@
+#include "AllocationTags.hpp"
+
+#include "Core/Logging/Logger.hpp"
+#include "Utility/Hashing.hpp"
+
+namespace QMBT
+{
+	namespace
+	{
+		// Open addressing table from name hashes to IDs, at most half full
+		constexpr Size s_TableSize = 2 * AllocationTagRegistry::MAX_TAGS;
+
+		struct Registry
+		{
+			// A key of 0 marks an empty slot. Keys are published after their ID and name, so a reader that
+			// sees a key can read both without a lock.
+			std::atomic<UInt32> keys[s_TableSize] = {};
+			UInt16 ids[s_TableSize] = {};
+			std::string names[AllocationTagRegistry::MAX_TAGS] = {"Untagged"};
+			std::atomic<Size> count{1};
+
+			std::mutex mutex; // Guards adding names
+		};
+
+		// Allocators may tag allocations while other statics are being constructed
+		Registry& GetRegistry()
+		{
+			static Registry s_Registry;
+			return s_Registry;
+		}
+
+		// Returns the slot holding the name, or the empty slot it would go in
+		Size FindSlot(const Registry& registry, const UInt32 key, const char* name)
+		{
+			for (Size slot = key & (s_TableSize - 1);; slot = (slot + 1) & (s_TableSize - 1))
+			{
+				const UInt32 slotKey = registry.keys[slot].load(std::memory_order_acquire);
+				if (slotKey == 0 || (slotKey == key && registry.names[registry.ids[slot]] == name))
+				{
+					return slot;
+				}
+			}
+		}
+	} // namespace
+
+	UInt16 AllocationTagRegistry::Intern(const char* name)
+	{
+		if (name == nullptr || *name == 0)
+		{
+			return UNTAGGED;
+		}
+
+		// 0 is reserved for empty slots
+		const UInt32 key = std::max(Utility::StringHash(name).Get(), 1u);
+
+		Registry& registry = GetRegistry();
+		Size slot = FindSlot(registry, key, name);
+		if (registry.keys[slot].load(std::memory_order_acquire) != 0)
+		{
+			return registry.ids[slot];
+		}
+
+		// Another thread may have added the name since the search
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		slot = FindSlot(registry, key, name);
+		if (registry.keys[slot].load(std::memory_order_relaxed) != 0)
+		{
+			return registry.ids[slot];
+		}
+
+		const Size id = registry.count.load(std::memory_order_relaxed);
+		if (id == MAX_TAGS)
+		{
+			LOG_MEMORY_WARN("Too many allocation tags, {0} is tracked as untagged", name);
+			return UNTAGGED;
+		}
+
+		registry.names[id] = name;
+		registry.ids[slot] = static_cast<UInt16>(id);
+		registry.keys[slot].store(key, std::memory_order_release);
+		registry.count.store(id + 1, std::memory_order_release);
+
+		return static_cast<UInt16>(id);
+	}
+
+	const char* AllocationTagRegistry::GetName(const UInt16 id)
+	{
+		return GetRegistry().names[id].c_str();
+	}
+
+	Size AllocationTagRegistry::GetTagCount()
+	{
+		return GetRegistry().count.load(std::memory_order_acquire);
+	}
+} // namespace QMBT
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "Core/Aliases.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief Turns the names that allocations are tracked under into small integer IDs.
+	 * @details A name is hashed with Utility::StringHash and looked up without taking a lock, only names that
+	 * have not been seen before are added under one. Allocators keep a counter per ID, so tracking an allocation
+	 * never has to build or hash a string.
+	 *
+	 */
+	class AllocationTagRegistry
+	{
+	  public:
+		// IDs after this many names are all UNTAGGED
+		static constexpr Size MAX_TAGS = 256;
+		static constexpr UInt16 UNTAGGED = 0;
+
+		/**
+		 * @brief Gets the ID of a name, adding it to the registry the first time it is seen. Thread safe.
+		 *
+		 * @param name Copied by the registry, so it does not have to outlive the call
+		 * @return UInt16 UNTAGGED for an empty name, or when the registry is full
+		 */
+		static UInt16 Intern(const char* name);
+
+		static const char* GetName(const UInt16 id);
+
+		// Every ID below this has a name
+		static Size GetTagCount();
+	};
+
+	// The interned name of an allocation. Holds no string, so it is as cheap to pass around as an integer.
+	class AllocationTag
+	{
+	  public:
+		AllocationTag() = default;
+		AllocationTag(const char* name)
+			: m_ID(AllocationTagRegistry::Intern(name)) {}
+
+		inline UInt16 GetID() const { return m_ID; }
+		inline bool IsTagged() const { return m_ID != AllocationTagRegistry::UNTAGGED; }
+
+	  private:
+		UInt16 m_ID = AllocationTagRegistry::UNTAGGED;
+	};
+} // namespace QMBT
@@ -0,0 +1,383 @@
+#include "AllocationTracker.hpp"
+
+#include "AllocatorData.hpp"
+#include "Core/Core.hpp"
+#include "Core/Logging/Logger.hpp"
+#include "Debug/StackTrace.hpp"
+#include "Utility/Size.hpp"
+
+namespace QMBT
+{
+	namespace
+	{
+		// Addresses of the live table slots that hold no sample. Removed slots can be reused, but do not end
+		// a search like empty ones do.
+		constexpr Size s_EmptySlot = 0;
+		constexpr Size s_RemovedSlot = 1;
+
+		// Slots searched before a sample is dropped, or a call stack is counted in the overflow site
+		constexpr Size s_MaxProbes = 32;
+		constexpr Size s_OverflowSite = AllocationTracker::MAX_SITES;
+
+		struct LiveSample
+		{
+			std::atomic<Size> address;
+			std::atomic<const AllocatorData*> allocator;
+			std::atomic<Size> size;
+			std::atomic<Size> site;
+			std::atomic<Size> weight; // The sample interval when it was taken
+		};
+
+		struct Site
+		{
+			// A key of 0 marks an unused site. The frames are published by ready, after the key is claimed.
+			std::atomic<UInt64> key;
+			std::atomic<bool> ready;
+			void* frames[AllocationTracker::MAX_FRAMES];
+			Size frameCount;
+
+			std::atomic<Size> allocationCount;
+			std::atomic<Size> allocatedSize;
+		};
+
+		// Zero initialised, so allocations can be tracked during static initialisation
+		LiveSample s_LiveTable[AllocationTracker::MAX_LIVE_SAMPLES];
+		Site s_Sites[AllocationTracker::MAX_SITES + 1];
+
+		thread_local bool t_Seeded = false;
+		thread_local UInt64 t_RandomState = 0;
+
+		inline Size GetLiveSlot(const void* ptr)
+		{
+			return (((Size)ptr >> 4) * 0x9E3779B97F4A7C15ull) >> 51;
+		}
+
+		// A uniformly distributed interval with the sample interval as mean, so allocations that repeat with a
+		// fixed period are not always or never sampled
+		Int64 GetNextCountdown(const Size sampleInterval)
+		{
+			if (t_RandomState == 0)
+			{
+				t_RandomState = ((UInt64)&t_RandomState ^ (UInt64)std::chrono::steady_clock::now().time_since_epoch().count()) | 1;
+			}
+
+			t_RandomState ^= t_RandomState >> 12;
+			t_RandomState ^= t_RandomState << 25;
+			t_RandomState ^= t_RandomState >> 27;
+			const UInt64 random = t_RandomState * 0x2545F4914F6CDD1Dull;
+
+			return 1 + (Int64)(random % (2 * sampleInterval - 1));
+		}
+
+		UInt64 HashFrames(void* const* frames, const Size frameCount)
+		{
+			UInt64 hash = 14695981039346656037ull;
+			for (Size i = 0; i < frameCount; i++)
+			{
+				hash = (hash ^ (UInt64)frames[i]) * 1099511628211ull;
+			}
+			return hash == 0 ? 1 : hash;
+		}
+
+		Size FindSite(void* const* frames, const Size frameCount)
+		{
+			const UInt64 key = HashFrames(frames, frameCount);
+
+			for (Size probe = 0; probe < s_MaxProbes; probe++)
+			{
+				const Size index = (key + probe) & (AllocationTracker::MAX_SITES - 1);
+				Site& site = s_Sites[index];
+
+				UInt64 siteKey = site.key.load(std::memory_order_relaxed);
+				if (siteKey == 0 && site.key.compare_exchange_strong(siteKey, key, std::memory_order_relaxed))
+				{
+					std::copy(frames, frames + frameCount, site.frames);
+					site.frameCount = frameCount;
+					site.ready.store(true, std::memory_order_release);
+					return index;
+				}
+				if (siteKey == key)
+				{
+					return index;
+				}
+			}
+
+			return s_OverflowSite;
+		}
+
+		void ClearSample(LiveSample& sample)
+		{
+			sample.allocator.store(nullptr, std::memory_order_relaxed);
+			sample.address.store(s_RemovedSlot, std::memory_order_relaxed);
+		}
+
+		LiveSample* FindSample(const void* ptr)
+		{
+			const Size start = GetLiveSlot(ptr);
+			for (Size probe = 0; probe < s_MaxProbes; probe++)
+			{
+				LiveSample& sample = s_LiveTable[(start + probe) & (AllocationTracker::MAX_LIVE_SAMPLES - 1)];
+				const Size address = sample.address.load(std::memory_order_relaxed);
+				if (address == (Size)ptr)
+				{
+					return &sample;
+				}
+				if (address == s_EmptySlot)
+				{
+					break;
+				}
+			}
+			return nullptr;
+		}
+
+		void LogFrames(const AllocationTracker::SiteReport& site)
+		{
+			if (site.FrameCount == 0)
+			{
+				LOG_MEMORY_INFO("    (too many sites to record this one)");
+			}
+			for (Size i = 0; i < site.FrameCount; i++)
+			{
+				LOG_MEMORY_INFO("    {0}", StackTrace::GetSymbol(site.Frames[i]));
+			}
+		}
+	} // namespace
+
+	std::atomic<Size> AllocationTracker::s_SampleInterval{0};
+	std::atomic<Size> AllocationTracker::s_LiveSamples{0};
+	std::atomic<Size> AllocationTracker::s_DroppedSamples{0};
+	std::atomic<UInt16> AllocationTracker::s_Filter[FILTER_SIZE] = {};
+	thread_local Int64 AllocationTracker::s_Countdown = 0;
+
+	void AllocationTracker::Enable(const Size sampleInterval)
+	{
+		QMBT_CORE_ASSERT(sampleInterval > 0, "Sample interval must be at least 1");
+
+		// Loads the unwinder now, rather than in the middle of the first sampled allocation
+		void* frame;
+		StackTrace::Capture(&frame, 1);
+
+		s_SampleInterval.store(sampleInterval, std::memory_order_relaxed);
+
+		// Other threads finish the interval they are counting down first
+		s_Countdown = 0;
+		t_Seeded = false;
+
+		LOG_MEMORY_INFO("Sampling 1 in {0} allocations", sampleInterval);
+	}
+
+	void AllocationTracker::Disable()
+	{
+		s_SampleInterval.store(0, std::memory_order_relaxed);
+	}
+
+	bool AllocationTracker::Record(const AllocatorData* allocator, const void* ptr, const Size size)
+	{
+		const Size sampleInterval = s_SampleInterval.load(std::memory_order_relaxed);
+		if (sampleInterval == 0)
+		{
+			return false;
+		}
+
+		// A thread starts somewhere inside its first interval, rather than sampling its first allocation
+		if (!t_Seeded)
+		{
+			t_Seeded = true;
+			s_Countdown = GetNextCountdown(sampleInterval) - 1;
+			if (s_Countdown > 0)
+			{
+				return false;
+			}
+		}
+		s_Countdown = GetNextCountdown(sampleInterval);
+
+		if (ptr == nullptr)
+		{
+			return false;
+		}
+
+		void* frames[MAX_FRAMES];
+		const Size frameCount = StackTrace::Capture(frames, MAX_FRAMES, 1);
+
+		const Size siteIndex = FindSite(frames, frameCount);
+		Site& site = s_Sites[siteIndex];
+		site.allocationCount.fetch_add(sampleInterval, std::memory_order_relaxed);
+		site.allocatedSize.fetch_add(size * sampleInterval, std::memory_order_relaxed);
+
+		const Size start = GetLiveSlot(ptr);
+		for (Size probe = 0; probe < s_MaxProbes; probe++)
+		{
+			LiveSample& sample = s_LiveTable[(start + probe) & (MAX_LIVE_SAMPLES - 1)];
+
+			Size address = sample.address.load(std::memory_order_relaxed);
+			if (address <= s_RemovedSlot && sample.address.compare_exchange_strong(address, (Size)ptr, std::memory_order_relaxed))
+			{
+				sample.allocator.store(allocator, std::memory_order_relaxed);
+				sample.size.store(size, std::memory_order_relaxed);
+				sample.site.store(siteIndex, std::memory_order_relaxed);
+				sample.weight.store(sampleInterval, std::memory_order_relaxed);
+
+				s_Filter[GetFilterIndex(ptr)].fetch_add(1, std::memory_order_relaxed);
+				s_LiveSamples.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		s_DroppedSamples.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	void AllocationTracker::Remove(const void* ptr)
+	{
+		LiveSample* sample = FindSample(ptr);
+		if (sample != nullptr)
+		{
+			ClearSample(*sample);
+			s_Filter[GetFilterIndex(ptr)].fetch_sub(1, std::memory_order_relaxed);
+			s_LiveSamples.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	void AllocationTracker::Resize(const void* ptr, const Size newSize)
+	{
+		LiveSample* sample = FindSample(ptr);
+		if (sample != nullptr)
+		{
+			sample->size.store(newSize, std::memory_order_relaxed);
+		}
+	}
+
+	void AllocationTracker::OnRelease(const AllocatorData* allocator)
+	{
+		if (s_LiveSamples.load(std::memory_order_relaxed) == 0)
+		{
+			return;
+		}
+
+		for (LiveSample& sample : s_LiveTable)
+		{
+			const Size address = sample.address.load(std::memory_order_relaxed);
+			if (address > s_RemovedSlot && sample.allocator.load(std::memory_order_relaxed) == allocator)
+			{
+				ClearSample(sample);
+				s_Filter[GetFilterIndex((const void*)address)].fetch_sub(1, std::memory_order_relaxed);
+				s_LiveSamples.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	std::vector<AllocationTracker::SiteReport> AllocationTracker::GetTopSites(const Size maxSites, const bool liveOnly)
+	{
+		std::vector<Size> liveCounts(MAX_SITES + 1, 0);
+		std::vector<Size> liveSizes(MAX_SITES + 1, 0);
+		for (const LiveSample& sample : s_LiveTable)
+		{
+			if (sample.address.load(std::memory_order_relaxed) > s_RemovedSlot)
+			{
+				const Size site = sample.site.load(std::memory_order_relaxed);
+				const Size weight = sample.weight.load(std::memory_order_relaxed);
+				liveCounts[site] += weight;
+				liveSizes[site] += sample.size.load(std::memory_order_relaxed) * weight;
+			}
+		}
+
+		std::vector<SiteReport> reports;
+		for (Size index = 0; index <= MAX_SITES; index++)
+		{
+			const Site& site = s_Sites[index];
+			const Size allocationCount = site.allocationCount.load(std::memory_order_relaxed);
+			if (allocationCount == 0 || (liveOnly && liveCounts[index] == 0))
+			{
+				continue;
+			}
+
+			SiteReport report = {};
+			if (index != s_OverflowSite && site.ready.load(std::memory_order_acquire))
+			{
+				std::copy(site.frames, site.frames + site.frameCount, report.Frames);
+				report.FrameCount = site.frameCount;
+			}
+			report.AllocationCount = allocationCount;
+			report.AllocatedSize = site.allocatedSize.load(std::memory_order_relaxed);
+			report.LiveCount = liveCounts[index];
+			report.LiveSize = liveSizes[index];
+			reports.push_back(report);
+		}
+
+		std::sort(reports.begin(), reports.end(), [liveOnly](const SiteReport& a, const SiteReport& b) {
+			return liveOnly ? a.LiveSize > b.LiveSize : a.AllocatedSize > b.AllocatedSize;
+		});
+		if (reports.size() > maxSites)
+		{
+			reports.resize(maxSites);
+		}
+
+		return reports;
+	}
+
+	void AllocationTracker::LogReport(const Size maxSites)
+	{
+		const std::vector<SiteReport> topSites = GetTopSites(maxSites);
+		LOG_MEMORY_INFO("Top {0} allocation sites:", topSites.size());
+		for (Size i = 0; i < topSites.size(); i++)
+		{
+			const SiteReport& site = topSites[i];
+			LOG_MEMORY_INFO("#{0}: {1} in about {2} allocations, {3} still live", i + 1, Utility::ToReadable(site.AllocatedSize),
+							site.AllocationCount, Utility::ToReadable(site.LiveSize));
+			LogFrames(site);
+		}
+
+		const std::vector<SiteReport> liveSites = GetTopSites(maxSites, true);
+		if (liveSites.empty())
+		{
+			LOG_MEMORY_INFO("No sampled allocations are live");
+		}
+		for (Size i = 0; i < liveSites.size(); i++)
+		{
+			const SiteReport& site = liveSites[i];
+			LOG_MEMORY_WARN("Live #{0}: about {1} allocations with {2} not freed", i + 1, site.LiveCount, Utility::ToReadable(site.LiveSize));
+			LogFrames(site);
+		}
+
+		if (GetDroppedSampleCount() > 0)
+		{
+			LOG_MEMORY_WARN("{0} samples did not fit in the live table", GetDroppedSampleCount());
+		}
+	}
+
+	Size AllocationTracker::GetLiveSampleCount(const AllocatorData* allocator)
+	{
+		Size count = 0;
+		for (const LiveSample& sample : s_LiveTable)
+		{
+			if (sample.address.load(std::memory_order_relaxed) > s_RemovedSlot &&
+				(allocator == nullptr || sample.allocator.load(std::memory_order_relaxed) == allocator))
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+
+	void AllocationTracker::Clear()
+	{
+		for (LiveSample& sample : s_LiveTable)
+		{
+			sample.address.store(s_EmptySlot, std::memory_order_relaxed);
+			sample.allocator.store(nullptr, std::memory_order_relaxed);
+		}
+		for (Site& site : s_Sites)
+		{
+			site.key.store(0, std::memory_order_relaxed);
+			site.ready.store(false, std::memory_order_relaxed);
+			site.allocationCount.store(0, std::memory_order_relaxed);
+			site.allocatedSize.store(0, std::memory_order_relaxed);
+		}
+		for (std::atomic<UInt16>& count : s_Filter)
+		{
+			count.store(0, std::memory_order_relaxed);
+		}
+		s_LiveSamples.store(0, std::memory_order_relaxed);
+		s_DroppedSamples.store(0, std::memory_order_relaxed);
+	}
+} // namespace QMBT
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "Core/Aliases.hpp"
+
+namespace QMBT
+{
+	struct AllocatorData;
+
+	/**
+	 * @brief Finds out where the memory of the engine allocators goes, by recording the call stack of roughly
+	 * 1 in N allocations.
+	 * @details Tracking is off until Enable is called. While it is off, every hook is a single relaxed load.
+	 * While it is on, each thread counts down a randomised interval and only captures a call stack when the
+	 * count runs out, so the cost per allocation stays at a few nanoseconds. Sampled allocations are kept in a
+	 * fixed-size lock-free table until they are freed, and grouped by call stack into allocation sites. Nothing
+	 * is ever allocated while recording, so the allocators themselves can be tracked.
+	 *
+	 * Allocators call the hooks: OnAllocate once the memory is handed out, and OnDeallocate before the memory is
+	 * given back, so the address cannot be reused while it is still in the table.
+	 *
+	 */
+	class AllocationTracker
+	{
+	  public:
+		static constexpr Size DEFAULT_SAMPLE_INTERVAL = 8192;
+		static constexpr Size MAX_FRAMES = 16;
+		// Call stacks past this many sites are all counted in one site without frames
+		static constexpr Size MAX_SITES = 1024;
+		// Samples that do not fit in the live table are dropped, and counted in GetDroppedSampleCount
+		static constexpr Size MAX_LIVE_SAMPLES = 8192;
+
+		struct SiteReport
+		{
+			void* Frames[MAX_FRAMES];
+			Size FrameCount;
+
+			// Estimated from the samples, so only meaningful for sites that are sampled often
+			Size AllocationCount;
+			Size AllocatedSize;
+			Size LiveCount;
+			Size LiveSize;
+		};
+
+		/**
+		 * @brief Starts sampling allocations. Can be called again to change the interval, which the calling thread
+		 * uses right away and other threads once they are done counting down their current one.
+		 *
+		 * @param sampleInterval On average, one in this many allocations is sampled. 1 records every allocation.
+		 */
+		static void Enable(const Size sampleInterval = DEFAULT_SAMPLE_INTERVAL);
+
+		// Stops sampling new allocations. Allocations that have been sampled are still removed once freed.
+		static void Disable();
+
+		inline static bool IsEnabled() { return s_SampleInterval.load(std::memory_order_relaxed) != 0; }
+		inline static Size GetSampleInterval() { return s_SampleInterval.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief Decides whether to sample an allocation, and records it if so
+		 *
+		 * @return bool True if the allocation was sampled
+		 */
+		inline static bool OnAllocate(const AllocatorData* allocator, const void* ptr, const Size size)
+		{
+			if (s_SampleInterval.load(std::memory_order_relaxed) == 0 || --s_Countdown > 0)
+			{
+				return false;
+			}
+			return Record(allocator, ptr, size);
+		}
+
+		inline static void OnDeallocate(const void* ptr)
+		{
+			if (MaybeSampled(ptr))
+			{
+				Remove(ptr);
+			}
+		}
+
+		// Keeps the size of a sampled allocation up to date when it is resized in place
+		inline static void OnResize(const void* ptr, const Size newSize)
+		{
+			if (MaybeSampled(ptr))
+			{
+				Resize(ptr, newSize);
+			}
+		}
+
+		// Forgets the sampled allocations of an allocator that freed all of its memory at once
+		static void OnRelease(const AllocatorData* allocator);
+
+		/**
+		 * @brief Groups the samples by call stack
+		 *
+		 * @param maxSites Only this many sites are returned, those that allocated the most bytes first
+		 * @param liveOnly Only returns the sites with live samples, those with the most live bytes first
+		 */
+		static std::vector<SiteReport> GetTopSites(const Size maxSites, const bool liveOnly = false);
+
+		/**
+		 * @brief Logs the sites that allocated the most, and the sites of the sampled allocations that are still
+		 * live. Call it at shutdown, after everything that should have freed its memory has done so.
+		 *
+		 * @param maxSites The number of sites in each list
+		 */
+		static void LogReport(const Size maxSites = 10);
+
+		// Counts the sampled allocations that have not been freed yet, of all allocators if allocator is nullptr
+		static Size GetLiveSampleCount(const AllocatorData* allocator = nullptr);
+		inline static Size GetDroppedSampleCount() { return s_DroppedSamples.load(std::memory_order_relaxed); }
+
+		// Forgets every sample and site. No allocator may be in use on another thread meanwhile.
+		static void Clear();
+
+	  private:
+		// Counts the live samples per address hash, so frees of allocations that were never sampled rarely
+		// have to search the live table
+		static constexpr Size FILTER_SIZE = 16384;
+
+		inline static Size GetFilterIndex(const void* ptr)
+		{
+			return (((Size)ptr >> 4) * 0x9E3779B97F4A7C15ull) >> 50;
+		}
+
+		inline static bool MaybeSampled(const void* ptr)
+		{
+			return s_LiveSamples.load(std::memory_order_relaxed) != 0 &&
+				   s_Filter[GetFilterIndex(ptr)].load(std::memory_order_relaxed) != 0;
+		}
+
+		static bool Record(const AllocatorData* allocator, const void* ptr, const Size size);
+		static void Remove(const void* ptr);
+		static void Resize(const void* ptr, const Size newSize);
+
+		static std::atomic<Size> s_SampleInterval;
+		static std::atomic<Size> s_LiveSamples;
+		static std::atomic<Size> s_DroppedSamples;
+		static std::atomic<UInt16> s_Filter[FILTER_SIZE];
+
+		// Allocations left until this thread samples the next one
+		static thread_local Int64 s_Countdown;
+	};
+} // namespace QMBT
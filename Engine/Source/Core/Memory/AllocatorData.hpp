@@ -2,10 +2,12 @@
 
 #include <QMBTPCH.hpp>
 
+#include "AllocationTags.hpp"
 #include "Core/Aliases.hpp"
 #include "Core/Types/SharedPtr.hpp"
 #include "Core/Types/String.hpp"
 #include "Core/Types/UnorderedMap.hpp"
+#include "Utility/MemoryUtils.hpp"
 
 namespace QMBT
 {
@@ -16,14 +18,97 @@ namespace QMBT
 	 */
 	struct AllocatorData
 	{
+		// Free blocks of at least 2^i bytes and less than 2^(i+1) bytes are counted in bucket i
+		static constexpr Size FREE_BLOCK_HISTOGRAM_SIZE = 40;
+
 		const char* DebugName;
-		Size TotalSize;
-		Size UsedSize;
-		std::unordered_map<std::string, Size> Allocations;
+		Size TotalSize;		// Reserved from the OS
+		Size CommittedSize; // The part of TotalSize that is backed by physical memory
+		std::atomic<Size> UsedSize; // Read by the MemoryManager and the editor while the allocator writes it
+		Size ReservedSize = 0; // Only kept by allocators that reserve address space without counting it in TotalSize
+		std::array<std::atomic<Size>, AllocationTagRegistry::MAX_TAGS> TaggedSizes = {}; // Indexed by tag ID
+
+		// Only kept by allocators with blocks of any size, which set HasFreeBlockStats. They are updated on
+		// every change, never computed by walking the blocks.
+		bool HasFreeBlockStats = false;
+		Size FreeBlockCount = 0;
+		Size FreeSize = 0; // All the free blocks together
+		Size LargestFreeBlock = 0;
+		Size OverheadSize = 0; // Headers and alignment padding of the allocations, included in UsedSize
+		std::array<Size, FREE_BLOCK_HISTOGRAM_SIZE> FreeBlockHistogram = {};
+
+		struct PoolBlock
+		{
+			Size ChunkCount;
+			Size UsedChunks;
+		};
+
+		// Only kept by stack allocators and arenas. The highest UsedSize since the last reset, and the one before the reset,
+		// which for a frame allocator is the high-water mark of the last frame.
+		Size PeakUsedSize = 0;
+		Size LastPeakUsedSize = 0;
+
+		// Only kept by single threaded pool allocators, one per block in address order
+		std::vector<PoolBlock> PoolBlocks;
 
 		AllocatorData(const char* debugName, Size totalSize)
-			: DebugName(debugName), TotalSize(totalSize), UsedSize(0)
+			: DebugName(debugName), TotalSize(totalSize), CommittedSize(totalSize), UsedSize(0)
+		{
+		}
+
+		// Untagged allocations are not counted, so they never touch a shared counter
+		inline void AddTaggedSize(const AllocationTag tag, const Size size)
+		{
+			if (tag.IsTagged())
+			{
+				TaggedSizes[tag.GetID()].fetch_add(size, std::memory_order_relaxed);
+			}
+		}
+
+		inline void RemoveTaggedSize(const AllocationTag tag, const Size size)
+		{
+			if (tag.IsTagged())
+			{
+				TaggedSizes[tag.GetID()].fetch_sub(size, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * @brief How much of the free memory cannot be used by a single allocation
+		 *
+		 * @return float 0 when all the free memory is in one block, close to 1 when it is spread over many small ones
+		 */
+		inline float GetExternalFragmentation() const
+		{
+			return FreeSize == 0 ? 0.0f : 1.0f - static_cast<float>(LargestFreeBlock) / static_cast<float>(FreeSize);
+		}
+
+		inline static Size GetHistogramBucket(const Size blockSize)
 		{
+			return std::min<Size>(Utility::FindLastSet(std::max<Size>(blockSize, 1)), FREE_BLOCK_HISTOGRAM_SIZE - 1);
+		}
+
+		// LargestFreeBlock is kept by the allocator itself
+		inline void AddFreeBlock(const Size blockSize)
+		{
+			FreeBlockCount++;
+			FreeSize += blockSize;
+			FreeBlockHistogram[GetHistogramBucket(blockSize)]++;
+		}
+
+		inline void RemoveFreeBlock(const Size blockSize)
+		{
+			FreeBlockCount--;
+			FreeSize -= blockSize;
+			FreeBlockHistogram[GetHistogramBucket(blockSize)]--;
+		}
+
+		inline void ClearFreeBlocks()
+		{
+			FreeBlockCount = 0;
+			FreeSize = 0;
+			LargestFreeBlock = 0;
+			FreeBlockHistogram.fill(0);
 		}
 	};
 
@@ -35,6 +120,28 @@ namespace QMBT
 		Resizable
 	};
 
+	enum class ThreadingPolicy : UInt8
+	{
+		SingleThreaded, // Only ever used by one thread at a time
+		MultiThreaded	// Any thread may allocate, and free what another thread allocated
+	};
+
+	// How much room each chunk of a pool allocator takes
+	enum class PaddingPolicy : UInt8
+	{
+		None,	  // Just the object, rounded up to its alignment
+		CacheLine // Whole cache lines, so objects used by different threads never share one
+	};
+
+	// Where an allocator that owns a large region gets it from
+	enum class BackingPolicy : UInt8
+	{
+		Heap,				  // malloc. Nothing is given back to the OS before the allocator is destroyed.
+		Pages,				  // Pages mapped from the OS. Spans that are not in use are given back.
+		TransparentHugePages, // Like Pages, but asks the kernel to back the region with huge pages
+		HugeTLB				  // Like Pages, but takes reserved huge pages. Falls back to TransparentHugePages if none are left.
+	};
+
 	struct Chunk
 	{
 		/*
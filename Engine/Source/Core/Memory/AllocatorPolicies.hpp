@@ -0,0 +1,171 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "AllocationTracker.hpp"
+#include "AllocatorData.hpp"
+#include "Core/Aliases.hpp"
+#include "Core/Core.hpp"
+#include "Core/Logging/Logger.hpp"
+#include "MemoryManager.hpp"
+
+namespace QMBT
+{
+	/*
+	The policies a PolicyAllocator is composed from. Every policy comes in a disabled version, an empty struct
+	whose hooks are inline and do nothing, so a disabled policy adds neither size nor code to the allocator.
+	Policies that need the debug name of the allocator keep it themselves, so it is only stored when used.
+	*/
+
+	// Locking
+
+	struct NoLocking
+	{
+		inline void Lock() {}
+		inline void Unlock() {}
+	};
+
+	// For allocators that are shared between threads
+	struct MutexLocking
+	{
+		inline void Lock() { m_Mutex.lock(); }
+		inline void Unlock() { m_Mutex.unlock(); }
+
+	  private:
+		std::mutex m_Mutex;
+	};
+
+	// Statistics
+
+	struct NoStatistics
+	{
+		static constexpr bool ENABLED = false;
+
+		inline void Initialize(const char* debugName) {}
+		inline void Shutdown() {}
+		inline void OnAllocate(const void* ptr, const Size size) {}
+		inline void OnDeallocate(const void* ptr, const Size size) {}
+	};
+
+	// Registers an AllocatorData with the MemoryManager, which counts the used size and feeds the AllocationTracker.
+	// The memory is owned by the backing allocator, so nothing is added to the total size.
+	// Allocators that keep an AllocatorData of their own only count their allocations in it if ENABLED is set.
+	struct AllocatorStatistics
+	{
+		static constexpr bool ENABLED = true;
+
+		inline void Initialize(const char* debugName)
+		{
+			m_Data = std::make_shared<AllocatorData>(debugName, 0);
+			MemoryManager::GetInstance().Register(m_Data);
+		}
+
+		inline void Shutdown()
+		{
+			AllocationTracker::OnRelease(m_Data.get());
+			MemoryManager::GetInstance().UnRegister(m_Data);
+		}
+
+		inline void OnAllocate(const void* ptr, const Size size)
+		{
+			m_Data->UsedSize += size;
+			AllocationTracker::OnAllocate(m_Data.get(), ptr, size);
+		}
+
+		inline void OnDeallocate(const void* ptr, const Size size)
+		{
+			AllocationTracker::OnDeallocate(ptr);
+			m_Data->UsedSize -= size;
+		}
+
+		inline const AllocatorData& GetAllocatorData() const { return *m_Data; }
+
+	  private:
+		std::shared_ptr<AllocatorData> m_Data;
+	};
+
+	// Bounds checking
+
+	struct NoBoundsChecking
+	{
+		static constexpr Size FRONT_GUARD_SIZE = 0;
+		static constexpr Size BACK_GUARD_SIZE = 0;
+
+		inline void Initialize(const char* debugName) {}
+		inline void WriteGuards(void* front, const Size size) {}
+		inline void CheckGuards(const void* front, const Size size) {}
+	};
+
+	/**
+	 * @brief Surrounds every allocation with bytes of a known pattern and checks them when it is freed, which
+	 * catches most writes past either end of a block.
+	 * @details The front guard is as large as the largest alignment it supports, so the block after it keeps the
+	 * alignment of the backing allocation.
+	 */
+	struct GuardBoundsChecking
+	{
+		static constexpr Size FRONT_GUARD_SIZE = 16;
+		static constexpr Size BACK_GUARD_SIZE = 16;
+		static constexpr UInt8 GUARD_PATTERN = 0xFD;
+
+		inline void Initialize(const char* debugName) { m_DebugName = debugName; }
+
+		// front is the start of the backing allocation, size the size of the block between the guards
+		inline void WriteGuards(void* front, const Size size)
+		{
+			memset(front, GUARD_PATTERN, FRONT_GUARD_SIZE);
+			memset((UInt8*)front + FRONT_GUARD_SIZE + size, GUARD_PATTERN, BACK_GUARD_SIZE);
+		}
+
+		inline void CheckGuards(const void* front, const Size size)
+		{
+			const UInt8* frontGuard = (const UInt8*)front;
+			const UInt8* backGuard = frontGuard + FRONT_GUARD_SIZE + size;
+
+			const bool intact = std::all_of(frontGuard, frontGuard + FRONT_GUARD_SIZE, [](UInt8 byte) { return byte == GUARD_PATTERN; }) &&
+								std::all_of(backGuard, backGuard + BACK_GUARD_SIZE, [](UInt8 byte) { return byte == GUARD_PATTERN; });
+			if (!intact)
+			{
+				m_OverrunCount++;
+				LOG_MEMORY_ERROR("{0} Block of {1} bytes at {2} was written out of bounds", m_DebugName, size, (const void*)(frontGuard + FRONT_GUARD_SIZE));
+			}
+		}
+
+		// The number of freed blocks whose guards had been overwritten
+		inline Size GetOverrunCount() const { return m_OverrunCount; }
+
+	  private:
+		const char* m_DebugName;
+		Size m_OverrunCount = 0;
+	};
+
+	// Logging
+
+	struct NoLogging
+	{
+		inline void Initialize(const char* debugName) {}
+		inline void OnAllocate(const Size size) {}
+		inline void OnDeallocate(const Size size) {}
+	};
+
+	struct MemoryLogging
+	{
+		inline void Initialize(const char* debugName) { m_DebugName = debugName; }
+		inline void OnAllocate(const Size size) { LOG_MEMORY_INFO("{0} Allocated {1} bytes", m_DebugName, size); }
+		inline void OnDeallocate(const Size size) { LOG_MEMORY_INFO("{0} Deallocated {1} bytes", m_DebugName, size); }
+
+	  private:
+		const char* m_DebugName;
+	};
+
+	// The policies of the build, so the same allocator is fully tracked in diagnostics builds and costs nothing otherwise
+#ifdef QMBT_MEMORY_DIAGNOSTICS
+	using DefaultStatistics = AllocatorStatistics;
+	using DefaultBoundsChecking = GuardBoundsChecking;
+	using DefaultLogging = MemoryLogging;
+#else
+	using DefaultStatistics = NoStatistics;
+	using DefaultBoundsChecking = NoBoundsChecking;
+	using DefaultLogging = NoLogging;
+#endif
+} // namespace QMBT
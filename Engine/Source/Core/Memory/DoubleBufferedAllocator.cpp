@@ -0,0 +1,26 @@
+#include "DoubleBufferedAllocator.hpp"
+
+namespace QMBT
+{
+	DoubleBufferedAllocator::DoubleBufferedAllocator(const char* debugName, const Size bufferSize)
+		: m_BufferNames{std::string(debugName) + " 0", std::string(debugName) + " 1"},
+		  m_Buffers{{m_BufferNames[0].c_str(), bufferSize, BackingPolicy::Pages},
+					{m_BufferNames[1].c_str(), bufferSize, BackingPolicy::Pages}}
+	{
+	}
+
+	void DoubleBufferedAllocator::SwapBuffers()
+	{
+		m_CurrentBuffer ^= 1;
+		StackAllocator& buffer = m_Buffers[m_CurrentBuffer];
+
+#ifdef QMBT_DEBUG
+		// The stack is double-ended, so the free space between the two ends is left alone
+		UInt8* head = (UInt8*)buffer.GetHeadPtr();
+		memset(head, FREED_PATTERN, buffer.GetMarker());
+		memset(head + buffer.GetTopMarker(), FREED_PATTERN, buffer.GetAllocatorData().TotalSize - buffer.GetTopMarker());
+#endif
+
+		buffer.Reset();
+	}
+} // namespace QMBT
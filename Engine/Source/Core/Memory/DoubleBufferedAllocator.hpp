@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Core/Memory/StackAllocator.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief A linear allocator for data that is produced in one frame and consumed in the next
+	 * @details Two stack allocators take turns. Every frame allocates from one of them, and at the end of the
+	 * frame the application swaps to the other and resets it, which frees what was allocated the frame before
+	 * last. An allocation therefore stays valid until the end of the frame after the one it was made in.
+	 * Like FrameAllocator, nothing is freed one by one and destructors are never called.
+	 *
+	 * Debug builds overwrite a buffer with FREED_PATTERN before resetting it, so data that is read after its
+	 * two frames is garbage rather than quietly stale, and IsLive can be asserted where the data is consumed.
+	 */
+	class DoubleBufferedAllocator
+	{
+	  public:
+		static constexpr UInt8 FREED_PATTERN = 0xDD;
+
+		//Prohibit copying and moving, the stack allocators cannot be moved
+		DoubleBufferedAllocator(const DoubleBufferedAllocator&) = delete;
+		DoubleBufferedAllocator& operator=(const DoubleBufferedAllocator&) = delete;
+
+		/**
+		 * @brief Construct a new Double Buffered Allocator object.
+		 *
+		 * @param debugName The name that will appear in logs and any editor, followed by the index of each buffer.
+		 * @param bufferSize The most a single frame can allocate. Only the pages a frame uses are committed.
+		 */
+		DoubleBufferedAllocator(const char* debugName = "Double Buffered Allocator", const Size bufferSize = 16_MB);
+
+		// The memory is valid until the end of the next frame
+		inline void* Allocate(const Size size, const Size alignment = 8) { return GetCurrentBuffer().Allocate(size, alignment); }
+
+		template <typename Object, typename... Args>
+		Object* New(Args&&... argList)
+		{
+			void* address = Allocate(sizeof(Object), alignof(Object));
+			return new (address) Object(std::forward<Args>(argList)...);
+		}
+
+		// Frees everything allocated the frame before last. Called by the application once the frame has ended.
+		void SwapBuffers();
+
+		// Whether ptr was allocated in this frame or the last one, and so can still be used
+		inline bool IsLive(const void* ptr) const { return m_Buffers[0].Contains(ptr) || m_Buffers[1].Contains(ptr); }
+
+		inline StackAllocator& GetCurrentBuffer() { return m_Buffers[m_CurrentBuffer]; }
+		inline const StackAllocator& GetPreviousBuffer() const { return m_Buffers[m_CurrentBuffer ^ 1]; }
+
+		inline Size GetUsedSize() const { return m_Buffers[0].GetUsedSize() + m_Buffers[1].GetUsedSize(); }
+
+	  private:
+		// The stack allocators only keep a pointer to their names
+		std::array<std::string, 2> m_BufferNames;
+		StackAllocator m_Buffers[2];
+		Size m_CurrentBuffer = 0;
+	};
+} // namespace QMBT
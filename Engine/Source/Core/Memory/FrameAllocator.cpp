@@ -0,0 +1,14 @@
+#include "FrameAllocator.hpp"
+
+namespace QMBT
+{
+	FrameAllocator::FrameAllocator(const char* debugName, const Size totalSize)
+		: m_StackAllocator(debugName, totalSize, BackingPolicy::Pages)
+	{
+	}
+
+	void FrameAllocator::EndFrame()
+	{
+		m_StackAllocator.Reset();
+	}
+} // namespace QMBT
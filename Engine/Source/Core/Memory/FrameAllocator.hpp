@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Core/Memory/StackAllocator.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief A linear allocator for data that only lives until the end of the frame
+	 * @details Allocations are never freed one by one. The application resets the whole allocator at the end
+	 * of every frame, which only moves the top of the stack back, so per-frame data such as profiler rows and
+	 * event buffers costs nothing to free. Destructors are never called, so it is meant for data that does
+	 * not need them. The high-water mark of the last frame is kept in AllocatorData::LastPeakUsedSize.
+	 */
+	class FrameAllocator
+	{
+	  public:
+		//Prohibit copying and moving, the stack allocator cannot be moved
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+		/**
+		 * @brief Construct a new Frame Allocator object.
+		 *
+		 * @param debugName The name that will appear in logs and any editor.
+		 * @param totalSize The most a single frame can allocate. Only the pages a frame uses are committed.
+		 */
+		FrameAllocator(const char* debugName = "Frame Allocator", const Size totalSize = 16_MB);
+
+		// The memory is valid until the end of the current frame
+		inline void* Allocate(const Size size, const Size alignment = 8) { return m_StackAllocator.Allocate(size, alignment); }
+
+		template <typename Object, typename... Args>
+		Object* New(Args&&... argList)
+		{
+			void* address = Allocate(sizeof(Object), alignof(Object));
+			return new (address) Object(std::forward<Args>(argList)...);
+		}
+
+		// Frees everything allocated during the frame. Called by the application once the frame has ended.
+		void EndFrame();
+
+		// Frees the allocations made in a scope before the frame ends, see StackAllocatorScope
+		inline StackAllocator& GetStackAllocator() { return m_StackAllocator; }
+
+		inline Size GetUsedSize() const { return m_StackAllocator.GetUsedSize(); }
+		inline Size GetLastFramePeakSize() const { return m_StackAllocator.GetAllocatorData().LastPeakUsedSize; }
+
+	  private:
+		StackAllocator m_StackAllocator;
+	};
+} // namespace QMBT
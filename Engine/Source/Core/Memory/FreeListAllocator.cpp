@@ -1,14 +1,22 @@
 #include "FreeListAllocator.hpp"
 
+#include "AllocationTracker.hpp"
 #include "Core/Core.hpp"
 #include "MemoryManager.hpp"
+#include "PageAllocator.hpp"
 #include "Utility/MemoryUtils.hpp"
 
 namespace QMBT
 {
-	FreeListAllocator::FreeListAllocator(const char* debugName, const Size totalSize, const PlacementPolicy policy)
-		: m_Policy(policy), m_Data(std::make_shared<AllocatorData>(debugName, totalSize))
+	FreeListAllocator::FreeListAllocator(const char* debugName, const Size totalSize, const PlacementPolicy policy, const ResizePolicy resizePolicy,
+										 const BackingPolicy backingPolicy)
+		: m_Policy(policy), m_ResizePolicy(resizePolicy), m_BackingPolicy(backingPolicy),
+		  m_DecommitGranularity(PageAllocator::GetDecommitGranularity(backingPolicy)), m_RegionSize(totalSize),
+		  m_Data(std::make_shared<AllocatorData>(debugName, totalSize))
 	{
+		QMBT_CORE_ASSERT(policy != FIND_SEGREGATED || totalSize < SEGREGATED_MAX_BLOCK, "Region is too large for the segregated bins!");
+		m_Data->HasFreeBlockStats = true;
+
 		// Allows the memory manager to keep track of total allocated memory
 		MemoryManager::GetInstance().Register(m_Data);
 
@@ -19,179 +27,1061 @@ namespace QMBT
 	{
 		if (m_StartPtr != nullptr)
 		{
-			free(m_StartPtr);
+			PageAllocator::Unmap(m_StartPtr, m_RegionSize, m_BackingPolicy);
 			m_StartPtr = nullptr;
 		}
-		m_StartPtr = malloc(m_Data->TotalSize);
+		m_StartPtr = PageAllocator::Map(m_RegionSize, m_BackingPolicy);
 
 		this->Reset();
 	}
 
 	FreeListAllocator::~FreeListAllocator()
 	{
+		AllocationTracker::OnRelease(m_Data.get());
 		MemoryManager::GetInstance().UnRegister(m_Data);
-		free(m_StartPtr);
+		for (Region& region : m_Regions)
+		{
+			PageAllocator::Unmap(region.startPtr, region.size, m_BackingPolicy);
+		}
+		PageAllocator::Unmap(m_StartPtr, m_RegionSize, m_BackingPolicy);
 	}
 
-	void* FreeListAllocator::Allocate(const Size size, const Size alignment, const char* name)
+	void* FreeListAllocator::Allocate(const Size size, const Size alignment, const AllocationTag tag)
 	{
-		//QMBT_CORE_ASSERT(size >= sizeof(Node), "Allocation size must be bigger than size of Node");
 		QMBT_CORE_ASSERT(alignment >= 8, "Alignment must be 8 at least");
 
-		static Size allocationHeaderSize = sizeof(FreeListAllocator::AllocationHeader);
-		static Size freeHeaderSize = sizeof(FreeListAllocator::FreeHeader);
+		FreeBlockHeader* block = FindFreeBlock(size, alignment);
+		if (block == nullptr && m_ResizePolicy == ResizePolicy::Resizable)
+		{
+			block = AddRegion(size, alignment);
+		}
 
-		// Search through the free list for a free block that has enough space to allocate our data
-		Size padding;
-		Node* affectedNode;
-		Node* previousNode;
-		this->Find(size, alignment, padding, previousNode, affectedNode);
-		QMBT_CORE_ASSERT(affectedNode != nullptr, "Not enough memory");
+		if (block == nullptr)
+		{
+			LOG_MEMORY_ERROR("{0} out of memory!", m_Data->DebugName);
+			return nullptr;
+		}
 
-		const Size alignmentPadding = padding - allocationHeaderSize;
-		const Size requiredSize = size + padding;
+		RemoveFreeBlock(block);
 
-		const Size rest = affectedNode->data.blockSize - requiredSize;
+		const Size blockAddress = (Size)block;
+		const Size blockSize = GetBlockSize(block);
+		const Size padding = GetBlockPadding(blockAddress, alignment);
+		Size requiredSize = std::max(Utility::AlignForward(padding + size, 8), MIN_BLOCK_SIZE);
 
-		if (rest > 0)
+		// The allocation may touch any of the decommitted pages, so they count as committed again
+		DecommittedSpan span = {0, 0};
+		if (block->sizeAndFlags & BLOCK_DECOMMITTED)
 		{
-			// We have to split the block into the data block and a free block of size 'rest'
-			Node* newFreeNode = (Node*)((Size)affectedNode + requiredSize);
-			newFreeNode->data.blockSize = rest;
-			m_FreeList.Insert(affectedNode, newFreeNode);
+			span = *GetDecommittedSpan(blockAddress, blockSize);
+			m_Data->CommittedSize += span.end - span.start;
 		}
-		m_FreeList.Remove(previousNode, affectedNode);
 
-		// Setup data block
-		const Size headerAddress = (Size)affectedNode + alignmentPadding;
-		const Size dataAddress = headerAddress + allocationHeaderSize;
-		((FreeListAllocator::AllocationHeader*)headerAddress)->blockSize = requiredSize;
-		((FreeListAllocator::AllocationHeader*)headerAddress)->padding = alignmentPadding;
+		requiredSize = SplitBlock(blockAddress, blockSize, requiredSize, span);
+
+		// Free blocks are always merged with their neighbours, so the block before this one cannot be free
+		block->sizeAndFlags = requiredSize;
+
+		const Size dataAddress = blockAddress + padding;
+		((AllocationHeader*)(dataAddress - sizeof(AllocationHeader)))->padding = padding;
 
 		m_Data->UsedSize += requiredSize;
+		m_Data->OverheadSize += padding;
+		m_Data->AddTaggedSize(tag, requiredSize);
 
-		if (*name != 0)
+		if (m_Tracked)
 		{
-			m_Data->Allocations[name] += requiredSize;
+			AllocationTracker::OnAllocate(m_Data.get(), (void*)dataAddress, size);
 		}
 
 		return (void*)dataAddress;
 	}
 
-	void FreeListAllocator::Find(const Size size, const Size alignment, Size& padding, Node*& previousNode, Node*& foundNode)
+	void FreeListAllocator::Deallocate(void* ptr, const AllocationTag tag)
+	{
+		if (m_Tracked)
+		{
+			AllocationTracker::OnDeallocate(ptr);
+		}
+
+		const Size padding = ((AllocationHeader*)((Size)ptr - sizeof(AllocationHeader)))->padding;
+
+		const Size blockAddress = (Size)ptr - padding;
+		const Size blockSize = GetBlockSize((BlockHeader*)blockAddress);
+
+		m_Data->UsedSize -= blockSize;
+		m_Data->OverheadSize -= padding;
+		m_Data->RemoveTaggedSize(tag, blockSize);
+
+		ReleaseBlock(blockAddress, blockSize);
+	}
+
+	Size FreeListAllocator::AllocateN(void** ptrs, const Size count, const Size size, const Size alignment, const AllocationTag tag)
+	{
+		QMBT_CORE_ASSERT(alignment >= 8, "Alignment must be 8 at least");
+
+		if (count == 0)
+		{
+			return 0;
+		}
+
+		// Room for every block of the batch, even if each of them needs the worst case amount of padding
+		const Size worstCaseSize = std::max(Utility::AlignForward(sizeof(BlockHeader) + alignment + size, 8), MIN_BLOCK_SIZE);
+		const Size batchSize = count * worstCaseSize;
+
+		FreeBlockHeader* block = FindFreeBlock(batchSize, 8);
+		if (block == nullptr && m_ResizePolicy == ResizePolicy::Resizable)
+		{
+			block = AddRegion(batchSize, 8);
+		}
+
+		if (block == nullptr)
+		{
+			Size allocatedCount = 0;
+			while (allocatedCount < count && (ptrs[allocatedCount] = Allocate(size, alignment, tag)) != nullptr)
+			{
+				allocatedCount++;
+			}
+			return allocatedCount;
+		}
+
+		RemoveFreeBlock(block);
+
+		const Size blockAddress = (Size)block;
+		const Size blockSize = GetBlockSize(block);
+
+		DecommittedSpan span = {0, 0};
+		if (block->sizeAndFlags & BLOCK_DECOMMITTED)
+		{
+			span = *GetDecommittedSpan(blockAddress, blockSize);
+			m_Data->CommittedSize += span.end - span.start;
+		}
+
+		// Every allocation gets a block of its own, so each of them can be freed on its own later
+		Size offset = 0;
+		Size lastAddress = 0;
+		Size overheadSize = 0;
+		for (Size i = 0; i < count; i++)
+		{
+			lastAddress = blockAddress + offset;
+			const Size padding = GetBlockPadding(lastAddress, alignment);
+			const Size requiredSize = std::max(Utility::AlignForward(padding + size, 8), MIN_BLOCK_SIZE);
+
+			((BlockHeader*)lastAddress)->sizeAndFlags = requiredSize;
+			const Size dataAddress = lastAddress + padding;
+			((AllocationHeader*)(dataAddress - sizeof(AllocationHeader)))->padding = padding;
+			ptrs[i] = (void*)dataAddress;
+
+			offset += requiredSize;
+			overheadSize += padding;
+		}
+
+		// The last block takes the tail of the free block if it is too small to split off
+		const Size usedSize = SplitBlock(blockAddress, blockSize, offset, span);
+		((BlockHeader*)lastAddress)->sizeAndFlags += usedSize - offset;
+
+		m_Data->UsedSize += usedSize;
+		m_Data->OverheadSize += overheadSize;
+		m_Data->AddTaggedSize(tag, usedSize);
+
+		if (m_Tracked)
+		{
+			for (Size i = 0; i < count; i++)
+			{
+				AllocationTracker::OnAllocate(m_Data.get(), ptrs[i], size);
+			}
+		}
+
+		return count;
+	}
+
+	void FreeListAllocator::DeallocateN(void** ptrs, const Size count, const AllocationTag tag)
+	{
+		if (m_Tracked)
+		{
+			for (Size i = 0; i < count; i++)
+			{
+				AllocationTracker::OnDeallocate(ptrs[i]);
+			}
+		}
+
+		std::sort(ptrs, ptrs + count);
+
+		Size usedSize = 0;
+		Size overheadSize = 0;
+		for (Size i = 0; i < count;)
+		{
+			// Gather the run of blocks that follow each other in memory and release it as one block
+			const Size runAddress = (Size)ptrs[i] - ((AllocationHeader*)((Size)ptrs[i] - sizeof(AllocationHeader)))->padding;
+			Size runSize = 0;
+			for (; i < count; i++)
+			{
+				const Size padding = ((AllocationHeader*)((Size)ptrs[i] - sizeof(AllocationHeader)))->padding;
+				const Size blockAddress = (Size)ptrs[i] - padding;
+				if (blockAddress != runAddress + runSize)
+				{
+					break;
+				}
+
+				runSize += GetBlockSize((BlockHeader*)blockAddress);
+				overheadSize += padding;
+			}
+
+			usedSize += runSize;
+			ReleaseBlock(runAddress, runSize);
+		}
+
+		m_Data->UsedSize -= usedSize;
+		m_Data->OverheadSize -= overheadSize;
+		m_Data->RemoveTaggedSize(tag, usedSize);
+	}
+
+	void FreeListAllocator::ReleaseBlock(Size blockAddress, Size blockSize)
+	{
+		const bool previousFree = ((BlockHeader*)blockAddress)->sizeAndFlags & BLOCK_PREVIOUS_FREE;
+
+		// Merge with the physical neighbours. The end of the memory region is marked by an allocated block,
+		// and the first block never has the BLOCK_PREVIOUS_FREE flag, so neither merge can leave the region.
+		// The merged block keeps the larger decommitted span of the two, the other one counts as committed again.
+		DecommittedSpan span = {0, 0};
+		auto mergeSpan = [&](const BlockHeader* neighbour, const Size neighbourAddress) {
+			if (neighbour->sizeAndFlags & BLOCK_DECOMMITTED)
+			{
+				DecommittedSpan neighbourSpan = *GetDecommittedSpan(neighbourAddress, GetBlockSize(neighbour));
+				if (neighbourSpan.end - neighbourSpan.start > span.end - span.start)
+				{
+					std::swap(span, neighbourSpan);
+				}
+				m_Data->CommittedSize += neighbourSpan.end - neighbourSpan.start;
+			}
+		};
+
+		BlockHeader* nextBlock = (BlockHeader*)(blockAddress + blockSize);
+		if (nextBlock->sizeAndFlags & BLOCK_FREE)
+		{
+			RemoveFreeBlock((FreeBlockHeader*)nextBlock);
+			mergeSpan(nextBlock, (Size)nextBlock);
+			blockSize += GetBlockSize(nextBlock);
+		}
+
+		if (previousFree)
+		{
+			const Size previousSize = *(Size*)(blockAddress - sizeof(Size));
+			blockAddress -= previousSize;
+			RemoveFreeBlock((FreeBlockHeader*)blockAddress);
+			mergeSpan((BlockHeader*)blockAddress, blockAddress);
+			blockSize += previousSize;
+		}
+
+		FreeBlockHeader* freeBlock = (FreeBlockHeader*)blockAddress;
+		freeBlock->sizeAndFlags = blockSize | BLOCK_FREE;
+		*(Size*)(blockAddress + blockSize - sizeof(Size)) = blockSize;
+		((BlockHeader*)(blockAddress + blockSize))->sizeAndFlags |= BLOCK_PREVIOUS_FREE;
+
+		if (span.end > span.start)
+		{
+			*GetDecommittedSpan(blockAddress, blockSize) = span;
+			freeBlock->sizeAndFlags |= BLOCK_DECOMMITTED;
+		}
+
+		// Only give pages back when there are enough of them, so small frees never make a system call
+		if (m_DecommitGranularity != 0 && blockSize - (span.end - span.start) >= DECOMMIT_THRESHOLD)
+		{
+			DecommitBlock(freeBlock);
+		}
+
+		InsertFreeBlock(freeBlock);
+	}
+
+	bool FreeListAllocator::TryExpand(void* ptr, const Size newSize, const AllocationTag tag)
+	{
+		const Size padding = ((AllocationHeader*)((Size)ptr - sizeof(AllocationHeader)))->padding;
+
+		const Size blockAddress = (Size)ptr - padding;
+		BlockHeader* block = (BlockHeader*)blockAddress;
+		const Size blockSize = GetBlockSize(block);
+		const Size requiredSize = std::max(Utility::AlignForward(padding + newSize, 8), MIN_BLOCK_SIZE);
+
+		// A free block after this one is taken over completely, and whatever the allocation does not
+		// need of it is split off again below
+		Size availableSize = blockSize;
+		DecommittedSpan span = {0, 0};
+
+		BlockHeader* nextBlock = (BlockHeader*)(blockAddress + blockSize);
+		if (nextBlock->sizeAndFlags & BLOCK_FREE)
+		{
+			const Size nextSize = GetBlockSize(nextBlock);
+			if (blockSize + nextSize < requiredSize)
+			{
+				return false;
+			}
+
+			RemoveFreeBlock((FreeBlockHeader*)nextBlock);
+			if (nextBlock->sizeAndFlags & BLOCK_DECOMMITTED)
+			{
+				span = *GetDecommittedSpan((Size)nextBlock, nextSize);
+				m_Data->CommittedSize += span.end - span.start;
+			}
+			availableSize += nextSize;
+		}
+		else if (blockSize < requiredSize)
+		{
+			return false;
+		}
+
+		const Size newBlockSize = SplitBlock(blockAddress, availableSize, requiredSize, span);
+		block->sizeAndFlags = newBlockSize | (block->sizeAndFlags & BLOCK_PREVIOUS_FREE);
+
+		// Shrinking can leave a large committed tail behind, which is given back like a freed block
+		if (m_DecommitGranularity != 0 && newBlockSize < availableSize)
+		{
+			FreeBlockHeader* tail = (FreeBlockHeader*)(blockAddress + newBlockSize);
+			const Size tailSize = GetBlockSize(tail);
+			const DecommittedSpan tailSpan = (tail->sizeAndFlags & BLOCK_DECOMMITTED) ? *GetDecommittedSpan((Size)tail, tailSize) : DecommittedSpan{0, 0};
+			if (tailSize - (tailSpan.end - tailSpan.start) >= DECOMMIT_THRESHOLD)
+			{
+				DecommitBlock(tail);
+			}
+		}
+
+		m_Data->UsedSize += newBlockSize - blockSize;
+		m_Data->AddTaggedSize(tag, newBlockSize - blockSize);
+
+		if (m_Tracked)
+		{
+			AllocationTracker::OnResize(ptr, newSize);
+		}
+
+		return true;
+	}
+
+	void* FreeListAllocator::Reallocate(void* ptr, const Size newSize, const Size alignment, const AllocationTag tag)
+	{
+		if (ptr == nullptr)
+		{
+			return Allocate(newSize, alignment, tag);
+		}
+
+		if (TryExpand(ptr, newSize, tag))
+		{
+			return ptr;
+		}
+
+		void* newPtr = Allocate(newSize, alignment, tag);
+		if (newPtr == nullptr)
+		{
+			return nullptr;
+		}
+
+		// The old block holds at least as many bytes as were requested for it, copying all of them is safe
+		const Size padding = ((AllocationHeader*)((Size)ptr - sizeof(AllocationHeader)))->padding;
+		const Size oldSize = GetBlockSize((BlockHeader*)((Size)ptr - padding)) - padding;
+		memcpy(newPtr, ptr, std::min(oldSize, newSize));
+
+		Deallocate(ptr, tag);
+
+		return newPtr;
+	}
+
+	void FreeListAllocator::Reset()
+	{
+		AllocationTracker::OnRelease(m_Data.get());
+
+		m_Data->UsedSize = 0;
+		m_Data->OverheadSize = 0;
+
+		for (Region& region : m_Regions)
+		{
+			PageAllocator::Unmap(region.startPtr, region.size, m_BackingPolicy);
+			m_Data->TotalSize -= region.size;
+			MemoryManager::GetInstance().UpdateTotalSize(-(Int64)region.size);
+		}
+		m_Regions.clear();
+		m_Data->CommittedSize = m_Data->TotalSize;
+
+		m_Data->ClearFreeBlocks();
+		m_LargestBlockCount = 0;
+		m_FreeListHead = nullptr;
+		m_SizeTreeRoot = nullptr;
+		m_FirstLevelBitmap = 0;
+		memset(m_SecondLevelBitmaps, 0, sizeof(m_SecondLevelBitmaps));
+		memset(m_SegregatedBins, 0, sizeof(m_SegregatedBins));
+
+		InsertFreeBlock(InitRegion(m_StartPtr, m_RegionSize));
+	}
+
+	void FreeListAllocator::ReleaseIdleRegions()
+	{
+		const auto now = std::chrono::steady_clock::now();
+
+		for (auto it = m_Regions.begin(); it != m_Regions.end();)
+		{
+			// An empty region is a single free block that covers all of it
+			const BlockHeader* firstBlock = (BlockHeader*)it->startPtr;
+			const bool empty = (firstBlock->sizeAndFlags & BLOCK_FREE) &&
+							   GetBlockSize(firstBlock) == ((it->size - sizeof(BlockHeader)) & ~Size(7));
+
+			if (empty && !it->empty)
+			{
+				it->emptySince = now;
+			}
+			it->empty = empty;
+
+			if (empty && now - it->emptySince >= m_RegionIdleTime)
+			{
+				ReleaseRegion(*it);
+				it = m_Regions.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	Size FreeListAllocator::SplitBlock(const Size blockAddress, const Size blockSize, const Size requiredSize, DecommittedSpan span)
+	{
+		const Size rest = blockSize - requiredSize;
+		if (rest < MIN_BLOCK_SIZE)
+		{
+			// The tail is too small to hold a free block, so hand out the whole block
+			((BlockHeader*)(blockAddress + blockSize))->sizeAndFlags &= ~BLOCK_PREVIOUS_FREE;
+			return blockSize;
+		}
+
+		// Split off the tail of the block and give it back to the index. The tail reuses the footer of the
+		// original block, and the block after it is marked as following a free block.
+		const Size restAddress = blockAddress + requiredSize;
+		FreeBlockHeader* restBlock = (FreeBlockHeader*)restAddress;
+		restBlock->sizeAndFlags = rest | BLOCK_FREE;
+		*(Size*)(blockAddress + blockSize - sizeof(Size)) = rest;
+		((BlockHeader*)(blockAddress + blockSize))->sizeAndFlags |= BLOCK_PREVIOUS_FREE;
+
+		// The part of the span behind the header of the tail is still decommitted, and the tail stores
+		// the span in the same place as the original block
+		if (span.end > span.start)
+		{
+			span.start = std::max(span.start, Utility::AlignForward(restAddress + sizeof(FreeBlockHeader), m_DecommitGranularity));
+			if (span.start < span.end)
+			{
+				*GetDecommittedSpan(restAddress, rest) = span;
+				restBlock->sizeAndFlags |= BLOCK_DECOMMITTED;
+				m_Data->CommittedSize -= span.end - span.start;
+			}
+		}
+
+		InsertFreeBlock(restBlock);
+
+		return requiredSize;
+	}
+
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::InitRegion(void* startPtr, const Size size)
+	{
+		// The whole region starts out as one free block, followed by a zero sized allocated block that
+		// marks the end of the region
+		const Size blockSize = (size - sizeof(BlockHeader)) & ~Size(7);
+		const Size blockAddress = (Size)startPtr;
+
+		FreeBlockHeader* firstBlock = (FreeBlockHeader*)blockAddress;
+		firstBlock->sizeAndFlags = blockSize | BLOCK_FREE;
+		*(Size*)(blockAddress + blockSize - sizeof(Size)) = blockSize;
+		((BlockHeader*)(blockAddress + blockSize))->sizeAndFlags = BLOCK_PREVIOUS_FREE;
+
+		DecommitBlock(firstBlock);
+
+		return firstBlock;
+	}
+
+	void FreeListAllocator::DecommitBlock(FreeBlockHeader* block)
+	{
+		if (m_DecommitGranularity == 0)
+		{
+			return;
+		}
+
+		// Everything between the header and the span, which sits right before the footer
+		const Size blockAddress = (Size)block;
+		const Size blockSize = GetBlockSize(block);
+		const Size start = Utility::AlignForward(blockAddress + sizeof(FreeBlockHeader), m_DecommitGranularity);
+		const Size end = (Size)GetDecommittedSpan(blockAddress, blockSize) & ~(m_DecommitGranularity - 1);
+		if (end <= start)
+		{
+			return;
+		}
+
+		DecommittedSpan* span = GetDecommittedSpan(blockAddress, blockSize);
+		if (block->sizeAndFlags & BLOCK_DECOMMITTED)
+		{
+			m_Data->CommittedSize += span->end - span->start;
+		}
+
+		PageAllocator::Decommit((void*)start, end - start, m_BackingPolicy);
+
+		span->start = start;
+		span->end = end;
+		block->sizeAndFlags |= BLOCK_DECOMMITTED;
+		m_Data->CommittedSize -= end - start;
+	}
+
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::AddRegion(const Size size, const Size alignment)
+	{
+		// The new block has to pass the search of every placement policy. The segregated search rounds the
+		// worst case size up to the next bin, which adds at most a sixteenth.
+		const Size worstCaseSize = Utility::AlignForward(sizeof(BlockHeader) + alignment + size, 8);
+		const Size requiredSize = worstCaseSize + worstCaseSize / SEGREGATED_SL_COUNT + MIN_BLOCK_SIZE + sizeof(BlockHeader);
+		const Size regionSize = std::max(m_RegionSize, Utility::AlignForward(requiredSize, 4_KB));
+		if (m_Policy == FIND_SEGREGATED && regionSize >= SEGREGATED_MAX_BLOCK)
+		{
+			// Could not be binned, so it is as out of memory as a failed mapping
+			return nullptr;
+		}
+
+		Region region;
+		region.startPtr = PageAllocator::Map(regionSize, m_BackingPolicy);
+		region.size = regionSize;
+		if (region.startPtr == nullptr)
+		{
+			return nullptr;
+		}
+		m_Regions.push_back(region);
+
+		m_Data->TotalSize += regionSize;
+		m_Data->CommittedSize += regionSize;
+		MemoryManager::GetInstance().UpdateTotalSize(regionSize);
+		LOG_MEMORY_INFO("{0} mapped a new region of {1} bytes", m_Data->DebugName, regionSize);
+
+		InsertFreeBlock(InitRegion(region.startPtr, regionSize));
+		return FindFreeBlock(size, alignment);
+	}
+
+	void FreeListAllocator::ReleaseRegion(Region& region)
+	{
+		FreeBlockHeader* block = (FreeBlockHeader*)region.startPtr;
+		RemoveFreeBlock(block);
+		if (block->sizeAndFlags & BLOCK_DECOMMITTED)
+		{
+			const DecommittedSpan* span = GetDecommittedSpan((Size)block, GetBlockSize(block));
+			m_Data->CommittedSize += span->end - span->start;
+		}
+		PageAllocator::Unmap(region.startPtr, region.size, m_BackingPolicy);
+
+		m_Data->TotalSize -= region.size;
+		m_Data->CommittedSize -= region.size;
+		MemoryManager::GetInstance().UpdateTotalSize(-(Int64)region.size);
+		LOG_MEMORY_INFO("{0} released a region of {1} bytes", m_Data->DebugName, region.size);
+	}
+
+	Size FreeListAllocator::GetBlockPadding(const Size blockAddress, const Size alignment)
+	{
+		return sizeof(BlockHeader) + Utility::CalculatePaddingWithHeader(blockAddress + sizeof(BlockHeader), alignment, sizeof(AllocationHeader));
+	}
+
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::FindFreeBlock(const Size size, const Size alignment)
 	{
 		switch (m_Policy)
 		{
 		case FIND_FIRST:
-			FindFirst(size, alignment, padding, previousNode, foundNode);
+			return FindInList(size, alignment);
+		case FIND_BEST:
+			return FindInSizeTree(size, alignment);
+		case FIND_SEGREGATED:
+		{
+			// Search for a block that fits the data even if the worst case amount of alignment padding is needed
+			const Size worstCaseSize = std::max(Utility::AlignForward(sizeof(BlockHeader) + alignment + size, 8), MIN_BLOCK_SIZE);
+			return FindSegregated(worstCaseSize);
+		}
+		}
+
+		return nullptr;
+	}
+
+	void FreeListAllocator::InsertFreeBlock(FreeBlockHeader* block)
+	{
+		switch (m_Policy)
+		{
+		case FIND_FIRST:
+			InsertInList(block);
 			break;
 		case FIND_BEST:
-			FindBest(size, alignment, padding, previousNode, foundNode);
+			m_SizeTreeRoot = InsertInSizeTree(m_SizeTreeRoot, block);
+			break;
+		case FIND_SEGREGATED:
+			InsertSegregated(block);
 			break;
 		}
+
+		const Size blockSize = GetBlockSize(block);
+		TrackLargestBlock(blockSize);
+		m_Data->AddFreeBlock(blockSize);
+		m_Data->LargestFreeBlock = m_LargestBlocks[0];
 	}
 
-	void FreeListAllocator::FindFirst(const Size size, const Size alignment, Size& padding, Node*& previousNode, Node*& foundNode)
+	void FreeListAllocator::RemoveFreeBlock(FreeBlockHeader* block)
 	{
-		//Iterate list and return the first free block with a size >= than given size
-		Node* it = m_FreeList.head;
-		Node* itPrev = nullptr;
+		switch (m_Policy)
+		{
+		case FIND_FIRST:
+			RemoveFromList(block);
+			break;
+		case FIND_BEST:
+			m_SizeTreeRoot = RemoveFromSizeTree(m_SizeTreeRoot, block);
+			break;
+		case FIND_SEGREGATED:
+			RemoveSegregated(block);
+			break;
+		}
+
+		const Size blockSize = GetBlockSize(block);
+		m_Data->RemoveFreeBlock(blockSize);
+		UntrackLargestBlock(blockSize);
+		m_Data->LargestFreeBlock = m_LargestBlockCount != 0 ? m_LargestBlocks[0] : 0;
+	}
 
-		while (it != nullptr)
+	void FreeListAllocator::TrackLargestBlock(const Size blockSize)
+	{
+		// While every free block is tracked, any new one can be added. Otherwise the untracked blocks may be
+		// larger than the new one, unless it is at least as large as the smallest tracked block.
+		const bool allTracked = m_Data->FreeBlockCount == m_LargestBlockCount;
+		if (!allTracked || m_LargestBlockCount == TRACKED_LARGEST_BLOCKS)
 		{
-			padding = Utility::CalculatePaddingWithHeader((Size)it, alignment, sizeof(FreeListAllocator::AllocationHeader));
-			const Size requiredSpace = size + padding;
-			if (it->data.blockSize >= requiredSpace)
+			if (blockSize < m_LargestBlocks[m_LargestBlockCount - 1])
 			{
-				break;
+				return;
 			}
-			itPrev = it;
-			it = it->next;
 		}
-		previousNode = itPrev;
-		foundNode = it;
+
+		InsertLargestBlock(blockSize);
 	}
 
-	void FreeListAllocator::FindBest(const Size size, const Size alignment, Size& padding, Node*& previousNode, Node*& foundNode)
+	void FreeListAllocator::UntrackLargestBlock(const Size blockSize)
 	{
-		// Iterate WHOLE list keeping a pointer to the best fit
-		Size smallestDiff = std::numeric_limits<Size>::max();
-		Node* bestBlock = nullptr;
-		Node *it = m_FreeList.head,
-			 *itPrev = nullptr;
-		while (it != nullptr)
+		// Blocks smaller than the smallest tracked one were never tracked
+		if (m_LargestBlockCount == 0 || blockSize < m_LargestBlocks[m_LargestBlockCount - 1])
 		{
-			padding = Utility::CalculatePaddingWithHeader((Size)it, alignment, sizeof(FreeListAllocator::AllocationHeader));
-			const Size requiredSpace = size + padding;
-			if (it->data.blockSize >= requiredSpace && (it->data.blockSize - requiredSpace < smallestDiff))
+			return;
+		}
+
+		Size index = 0;
+		while (m_LargestBlocks[index] != blockSize)
+		{
+			index++;
+		}
+		m_LargestBlockCount--;
+		for (; index < m_LargestBlockCount; index++)
+		{
+			m_LargestBlocks[index] = m_LargestBlocks[index + 1];
+		}
+
+		if (m_LargestBlockCount == 0 && m_Data->FreeBlockCount != 0)
+		{
+			FindLargestBlocks();
+		}
+	}
+
+	void FreeListAllocator::InsertLargestBlock(const Size blockSize)
+	{
+		// The smallest tracked block is dropped when there is no room left
+		Size index = std::min(m_LargestBlockCount, TRACKED_LARGEST_BLOCKS - 1);
+		m_LargestBlockCount = index + 1;
+		for (; index > 0 && m_LargestBlocks[index - 1] < blockSize; index--)
+		{
+			m_LargestBlocks[index] = m_LargestBlocks[index - 1];
+		}
+		m_LargestBlocks[index] = blockSize;
+	}
+
+	void FreeListAllocator::FindLargestBlocks()
+	{
+		auto offer = [this](const FreeBlockHeader* block) {
+			const Size blockSize = GetBlockSize(block);
+			if (m_LargestBlockCount < TRACKED_LARGEST_BLOCKS || blockSize > m_LargestBlocks[TRACKED_LARGEST_BLOCKS - 1])
 			{
-				bestBlock = it;
+				InsertLargestBlock(blockSize);
 			}
-			itPrev = it;
-			it = it->next;
+		};
+
+		switch (m_Policy)
+		{
+		case FIND_FIRST:
+			for (FreeBlockHeader* it = m_FreeListHead; it != nullptr; it = it->next)
+			{
+				offer(it);
+			}
+			break;
+		case FIND_BEST:
+		{
+			// Walk the size tree from the right, stopping once enough blocks are found
+			FreeBlockHeader* stack[64];
+			Size stackSize = 0;
+			FreeBlockHeader* it = m_SizeTreeRoot;
+			while ((it != nullptr || stackSize != 0) && m_LargestBlockCount < TRACKED_LARGEST_BLOCKS)
+			{
+				for (; it != nullptr; it = it->right)
+				{
+					stack[stackSize++] = it;
+				}
+				it = stack[--stackSize];
+				offer(it);
+				it = it->left;
+			}
+			break;
+		}
+		case FIND_SEGREGATED:
+			// Every block of a bin is larger than the blocks of the bins below it, so the search can stop
+			// after the bin that fills up the tracked blocks
+			for (UInt64 firstLevelMap = m_FirstLevelBitmap; firstLevelMap != 0 && m_LargestBlockCount < TRACKED_LARGEST_BLOCKS;)
+			{
+				const Size firstLevel = Utility::FindLastSet(firstLevelMap);
+				firstLevelMap &= ~(UInt64(1) << firstLevel);
+
+				for (UInt32 secondLevelMap = m_SecondLevelBitmaps[firstLevel]; secondLevelMap != 0 && m_LargestBlockCount < TRACKED_LARGEST_BLOCKS;)
+				{
+					const Size secondLevel = Utility::FindLastSet(secondLevelMap);
+					secondLevelMap &= ~(UInt32(1) << secondLevel);
+
+					for (FreeBlockHeader* it = m_SegregatedBins[firstLevel][secondLevel]; it != nullptr; it = it->next)
+					{
+						offer(it);
+					}
+				}
+			}
+			break;
 		}
-		previousNode = itPrev;
-		foundNode = bestBlock;
 	}
 
-	void FreeListAllocator::Deallocate(void* ptr, const char* name)
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::FindInList(const Size size, const Size alignment) const
 	{
-		// Insert it in a sorted position by the address number
-		const Size headerAddress = (Size)ptr - sizeof(FreeListAllocator::AllocationHeader);
-		const FreeListAllocator::AllocationHeader* allocationHeader{(FreeListAllocator::AllocationHeader*)headerAddress};
+		// Iterate the list and return the first free block that fits the data along with its padding
+		for (FreeBlockHeader* it = m_FreeListHead; it != nullptr; it = it->next)
+		{
+			if (GetBlockSize(it) >= GetBlockPadding((Size)it, alignment) + size)
+			{
+				return it;
+			}
+		}
 
-		Node* freeNode = (Node*)(headerAddress);
-		freeNode->data.blockSize = allocationHeader->blockSize + allocationHeader->padding;
-		freeNode->next = nullptr;
+		return nullptr;
+	}
 
-		Node* it = m_FreeList.head;
-		Node* itPrev = nullptr;
-		while (it != nullptr)
+	void FreeListAllocator::InsertInList(FreeBlockHeader* block)
+	{
+		// Neighbours are found through the boundary tags, so the list does not need to be kept sorted
+		// by address and blocks can go straight to the front
+		block->next = m_FreeListHead;
+		block->previous = nullptr;
+		if (m_FreeListHead != nullptr)
 		{
-			if (ptr < it)
+			m_FreeListHead->previous = block;
+		}
+		m_FreeListHead = block;
+	}
+
+	void FreeListAllocator::RemoveFromList(FreeBlockHeader* block)
+	{
+		if (block->previous != nullptr)
+		{
+			block->previous->next = block->next;
+		}
+		else
+		{
+			m_FreeListHead = block->next;
+		}
+		if (block->next != nullptr)
+		{
+			block->next->previous = block->previous;
+		}
+	}
+
+	namespace
+	{
+		// Orders the size tree by block size first and address second
+		template <typename Block>
+		inline bool IsOrderedBefore(const Block* a, const Size aSize, const Block* b, const Size bSize)
+		{
+			return aSize < bSize || (aSize == bSize && a < b);
+		}
+
+		template <typename Block>
+		inline Size GetHeight(const Block* block)
+		{
+			return block != nullptr ? block->height : 0;
+		}
+
+		template <typename Block>
+		inline void UpdateHeight(Block* block)
+		{
+			block->height = 1 + std::max(GetHeight(block->left), GetHeight(block->right));
+		}
+
+		template <typename Block>
+		inline Block* RotateLeft(Block* block)
+		{
+			Block* pivot = block->right;
+			block->right = pivot->left;
+			pivot->left = block;
+			UpdateHeight(block);
+			UpdateHeight(pivot);
+			return pivot;
+		}
+
+		template <typename Block>
+		inline Block* RotateRight(Block* block)
+		{
+			Block* pivot = block->left;
+			block->left = pivot->right;
+			pivot->right = block;
+			UpdateHeight(block);
+			UpdateHeight(pivot);
+			return pivot;
+		}
+	} // namespace
+
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::FindInSizeTree(const Size size, const Size alignment) const
+	{
+		// Start from the smallest block that could hold the data with the least possible padding
+		const Size minimumSize = std::max(Utility::AlignForward(sizeof(BlockHeader) + sizeof(AllocationHeader) + size, 8), MIN_BLOCK_SIZE);
+
+		FreeBlockHeader* candidate = nullptr;
+		for (FreeBlockHeader* it = m_SizeTreeRoot; it != nullptr;)
+		{
+			if (GetBlockSize(it) >= minimumSize)
 			{
-				m_FreeList.Insert(itPrev, freeNode);
-				break;
+				candidate = it;
+				it = it->left;
+			}
+			else
+			{
+				it = it->right;
 			}
-			itPrev = it;
-			it = it->next;
 		}
 
-		m_Data->UsedSize -= freeNode->data.blockSize;
+		// A block can still be too small once its own alignment padding is added, in which case move on
+		// to the next block in size order. With the default alignment of 8 the first candidate always fits.
+		while (candidate != nullptr)
+		{
+			const Size candidateSize = GetBlockSize(candidate);
+			if (candidateSize >= GetBlockPadding((Size)candidate, alignment) + size)
+			{
+				return candidate;
+			}
+
+			FreeBlockHeader* successor = nullptr;
+			for (FreeBlockHeader* it = m_SizeTreeRoot; it != nullptr;)
+			{
+				if (IsOrderedBefore(candidate, candidateSize, it, GetBlockSize(it)))
+				{
+					successor = it;
+					it = it->left;
+				}
+				else
+				{
+					it = it->right;
+				}
+			}
+			candidate = successor;
+		}
 
-		if (*name != 0)
+		return nullptr;
+	}
+
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::InsertInSizeTree(FreeBlockHeader* root, FreeBlockHeader* block)
+	{
+		if (root == nullptr)
+		{
+			block->left = nullptr;
+			block->right = nullptr;
+			block->height = 1;
+			return block;
+		}
+
+		if (IsOrderedBefore(block, GetBlockSize(block), root, GetBlockSize(root)))
 		{
-			m_Data->Allocations[name] -= freeNode->data.blockSize;
+			root->left = InsertInSizeTree(root->left, block);
 		}
-		// Merge contiguous nodes
-		Coalescence(itPrev, freeNode);
+		else
+		{
+			root->right = InsertInSizeTree(root->right, block);
+		}
+
+		return BalanceSizeTree(root);
 	}
 
-	void FreeListAllocator::Coalescence(Node* previousNode, Node* freeNode)
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::RemoveFromSizeTree(FreeBlockHeader* root, FreeBlockHeader* block)
 	{
-		if (freeNode->next != nullptr &&
-			(Size)freeNode + freeNode->data.blockSize == (Size)freeNode->next)
+		if (root == block)
 		{
-			freeNode->data.blockSize += freeNode->next->data.blockSize;
-			m_FreeList.Remove(freeNode, freeNode->next);
+			if (root->left == nullptr)
+			{
+				return root->right;
+			}
+			if (root->right == nullptr)
+			{
+				return root->left;
+			}
+
+			// Replace the block with the smallest block of its right subtree
+			FreeBlockHeader* replacement = root->right;
+			while (replacement->left != nullptr)
+			{
+				replacement = replacement->left;
+			}
+			replacement->right = RemoveMinimumFromSizeTree(root->right);
+			replacement->left = root->left;
+
+			return BalanceSizeTree(replacement);
 		}
 
-		if (previousNode != nullptr &&
-			(Size)previousNode + previousNode->data.blockSize == (Size)freeNode)
+		if (IsOrderedBefore(block, GetBlockSize(block), root, GetBlockSize(root)))
+		{
+			root->left = RemoveFromSizeTree(root->left, block);
+		}
+		else
 		{
-			previousNode->data.blockSize += freeNode->data.blockSize;
-			m_FreeList.Remove(previousNode, freeNode);
+			root->right = RemoveFromSizeTree(root->right, block);
 		}
+
+		return BalanceSizeTree(root);
 	}
 
-	void FreeListAllocator::Reset()
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::RemoveMinimumFromSizeTree(FreeBlockHeader* root)
 	{
-		m_Data->UsedSize = 0;
-		Node* firstNode = (Node*)m_StartPtr;
-		firstNode->data.blockSize = m_Data->TotalSize;
-		firstNode->next = nullptr;
-		m_FreeList.head = nullptr;
-		m_FreeList.Insert(nullptr, firstNode);
+		if (root->left == nullptr)
+		{
+			return root->right;
+		}
+
+		root->left = RemoveMinimumFromSizeTree(root->left);
+
+		return BalanceSizeTree(root);
+	}
+
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::BalanceSizeTree(FreeBlockHeader* root)
+	{
+		// AVL rebalancing, keeps the heights of the two subtrees within one of each other
+		UpdateHeight(root);
+
+		const Int64 balance = Int64(GetHeight(root->left)) - Int64(GetHeight(root->right));
+		if (balance > 1)
+		{
+			if (GetHeight(root->left->left) < GetHeight(root->left->right))
+			{
+				root->left = RotateLeft(root->left);
+			}
+			return RotateRight(root);
+		}
+		if (balance < -1)
+		{
+			if (GetHeight(root->right->right) < GetHeight(root->right->left))
+			{
+				root->right = RotateRight(root->right);
+			}
+			return RotateLeft(root);
+		}
+
+		return root;
+	}
+
+	void FreeListAllocator::MapSegregated(const Size blockSize, Size& firstLevel, Size& secondLevel)
+	{
+		QMBT_CORE_ASSERT(blockSize < SEGREGATED_MAX_BLOCK, "Block is too large for the segregated bins!");
+
+		if (blockSize < SEGREGATED_SMALL_BLOCK)
+		{
+			// Small blocks are spread linearly over the first row
+			firstLevel = 0;
+			secondLevel = blockSize / (SEGREGATED_SMALL_BLOCK / SEGREGATED_SL_COUNT);
+		}
+		else
+		{
+			const Size log2 = Utility::FindLastSet(blockSize);
+			secondLevel = (blockSize >> (log2 - SEGREGATED_SL_COUNT_LOG2)) ^ SEGREGATED_SL_COUNT;
+			firstLevel = log2 - (SEGREGATED_FL_SHIFT - 1);
+		}
+	}
+
+	FreeListAllocator::FreeBlockHeader* FreeListAllocator::FindSegregated(const Size blockSize)
+	{
+		// Round the size up to the next bin boundary, so that every block in the bin we land on is big enough.
+		// This trades a little packing for never having to search through a bin.
+		Size searchSize = blockSize;
+		if (searchSize >= SEGREGATED_SMALL_BLOCK)
+		{
+			searchSize += (Size(1) << (Utility::FindLastSet(searchSize) - SEGREGATED_SL_COUNT_LOG2)) - 1;
+		}
+
+		// No block is that large
+		if (searchSize >= SEGREGATED_MAX_BLOCK)
+		{
+			return nullptr;
+		}
+
+		Size firstLevel, secondLevel;
+		MapSegregated(searchSize, firstLevel, secondLevel);
+
+		// Look for a non-empty bin in the same row first, then fall back to the smallest bin of the next
+		// non-empty row
+		UInt32 secondLevelMap = m_SecondLevelBitmaps[firstLevel] & (~UInt32(0) << secondLevel);
+		if (secondLevelMap == 0)
+		{
+			const UInt64 firstLevelMap = m_FirstLevelBitmap & (~UInt64(0) << (firstLevel + 1));
+			if (firstLevelMap == 0)
+			{
+				return nullptr;
+			}
+
+			firstLevel = Utility::FindFirstSet(firstLevelMap);
+			secondLevelMap = m_SecondLevelBitmaps[firstLevel];
+		}
+		secondLevel = Utility::FindFirstSet(secondLevelMap);
+
+		return m_SegregatedBins[firstLevel][secondLevel];
+	}
+
+	void FreeListAllocator::InsertSegregated(FreeBlockHeader* block)
+	{
+		Size firstLevel, secondLevel;
+		MapSegregated(GetBlockSize(block), firstLevel, secondLevel);
+
+		FreeBlockHeader* head = m_SegregatedBins[firstLevel][secondLevel];
+		block->next = head;
+		block->previous = nullptr;
+		if (head != nullptr)
+		{
+			head->previous = block;
+		}
+		m_SegregatedBins[firstLevel][secondLevel] = block;
+
+		m_FirstLevelBitmap |= UInt64(1) << firstLevel;
+		m_SecondLevelBitmaps[firstLevel] |= UInt32(1) << secondLevel;
+	}
+
+	void FreeListAllocator::RemoveSegregated(FreeBlockHeader* block)
+	{
+		Size firstLevel, secondLevel;
+		MapSegregated(GetBlockSize(block), firstLevel, secondLevel);
+
+		if (block->previous != nullptr)
+		{
+			block->previous->next = block->next;
+		}
+		else
+		{
+			m_SegregatedBins[firstLevel][secondLevel] = block->next;
+		}
+		if (block->next != nullptr)
+		{
+			block->next->previous = block->previous;
+		}
+
+		// Clear the bitmaps if the bin, and then possibly the row, became empty
+		if (m_SegregatedBins[firstLevel][secondLevel] == nullptr)
+		{
+			m_SecondLevelBitmaps[firstLevel] &= ~(UInt32(1) << secondLevel);
+			if (m_SecondLevelBitmaps[firstLevel] == 0)
+			{
+				m_FirstLevelBitmap &= ~(UInt64(1) << firstLevel);
+			}
+		}
 	}
 
 } // namespace QMBT
\ No newline at end of file
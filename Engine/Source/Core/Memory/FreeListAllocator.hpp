@@ -4,7 +4,6 @@
 
 #include "AllocatorData.hpp"
 #include "Core/Aliases.hpp"
-#include "Core/Types/SinglyLinkedList.hpp"
 
 namespace QMBT
 {
@@ -13,66 +12,262 @@ namespace QMBT
 	  public:
 		enum PlacementPolicy
 		{
-			FIND_FIRST, // For better speed, finds the first block of memory of sufficeint size.
-			FIND_BEST	// For better memory packing, finds all the blocks of memory of sufficient size and chooses the
-						// one with the tightest fit.
+			FIND_FIRST,		// For better speed, finds the first block of memory of sufficeint size.
+			FIND_BEST,		// For better memory packing, keeps the free blocks in a size-ordered balanced tree and chooses
+							// the one with the tightest fit in O(log n).
+			FIND_SEGREGATED // For constant time placement, keeps the free blocks in size-class bins indexed by a two-level
+							// bitmap (TLSF) and takes a block from the smallest non-empty bin that is guaranteed to fit.
+							// Every region has to be smaller than SEGREGATED_MAX_BLOCK.
 		};
 
 	  private:
-		struct FreeHeader
+		/*
+		Every block carries boundary tags. It starts with a BlockHeader holding its size, and since sizes are
+		multiples of 8 the low bits store whether the block and its physical predecessor are free. A free block
+		also ends with a copy of its size (the footer), so the block after it can find its start in constant
+		time. Freeing a block therefore merges it with its neighbours without searching any list.
+		*/
+		struct BlockHeader
 		{
-			Size blockSize;
+			Size sizeAndFlags;
+		};
+		struct FreeBlockHeader : BlockHeader
+		{
+			// The free list and the segregated bins chain their blocks in doubly linked lists, the
+			// size tree stores its children in the same place.
+			union
+			{
+				FreeBlockHeader* next;
+				FreeBlockHeader* left;
+			};
+			union
+			{
+				FreeBlockHeader* previous;
+				FreeBlockHeader* right;
+			};
+			Size height; // Only used by the size tree
 		};
 		struct AllocationHeader
 		{
-			Size blockSize;
-			char padding;
+			Size padding; // Distance from the start of the block to the user data
+		};
+		// The pages inside a free block that have been given back to the OS. Free blocks with the
+		// BLOCK_DECOMMITTED flag store it right before their footer.
+		struct DecommittedSpan
+		{
+			Size start;
+			Size end;
 		};
 
-		using Node = SinglyLinkedList<FreeHeader>::Node;
+		static constexpr Size BLOCK_FREE = 1;
+		static constexpr Size BLOCK_PREVIOUS_FREE = 2;
+		static constexpr Size BLOCK_DECOMMITTED = 4;
+		static constexpr Size BLOCK_FLAGS = BLOCK_FREE | BLOCK_PREVIOUS_FREE | BLOCK_DECOMMITTED;
+		static constexpr Size MIN_BLOCK_SIZE = sizeof(FreeBlockHeader) + sizeof(Size);
+
+		// A free block is decommitted once it holds at least this many committed bytes
+		static constexpr Size DECOMMIT_THRESHOLD = 1_MB;
+
+		// Number of the largest free blocks whose sizes are tracked for the allocator statistics
+		static constexpr Size TRACKED_LARGEST_BLOCKS = 8;
+
+		// Two-level segregated fit parameters. The first level splits block sizes into powers of two, the
+		// second level splits each power of two into SEGREGATED_SL_COUNT linearly spaced bins. Blocks smaller
+		// than SEGREGATED_SMALL_BLOCK all go into the first row, which is spaced linearly by 8 bytes.
+		static constexpr Size SEGREGATED_SL_COUNT_LOG2 = 4;
+		static constexpr Size SEGREGATED_SL_COUNT = 1 << SEGREGATED_SL_COUNT_LOG2;
+		static constexpr Size SEGREGATED_FL_SHIFT = SEGREGATED_SL_COUNT_LOG2 + 3;
+		static constexpr Size SEGREGATED_FL_MAX = 40;
+		static constexpr Size SEGREGATED_FL_COUNT = SEGREGATED_FL_MAX - SEGREGATED_FL_SHIFT + 1;
+		static constexpr Size SEGREGATED_SMALL_BLOCK = 1 << SEGREGATED_FL_SHIFT;
+		// Blocks of this size or more would need another row of bins. A free block never spans two regions, so
+		// keeping every region below it is enough.
+		static constexpr Size SEGREGATED_MAX_BLOCK = Size(1) << SEGREGATED_FL_MAX;
+
+		// Extra memory mapped by a resizable allocator when none of its regions has a block large enough
+		struct Region
+		{
+			void* startPtr;
+			Size size;
+			std::chrono::steady_clock::time_point emptySince; // Only meaningful while the region is empty
+			bool empty = false;
+		};
 
 	  public:
-		FreeListAllocator(const char* debugName = "FreeListAllocator", const Size totalSize = 50_MB, const PlacementPolicy policy = PlacementPolicy::FIND_FIRST);
+		/**
+		 * @param totalSize The size of the first region. A resizable allocator maps further regions of at
+		 * least this size whenever it runs out of memory, and keeps the free blocks of all of them in one index.
+		 * With FIND_SEGREGATED it must be below SEGREGATED_MAX_BLOCK (1 TB).
+		 * @param backingPolicy Unless it is BackingPolicy::Heap, the pages inside large free blocks are given back
+		 * to the OS.
+		 */
+		FreeListAllocator(const char* debugName = "FreeListAllocator", const Size totalSize = 50_MB, const PlacementPolicy policy = PlacementPolicy::FIND_FIRST,
+						  const ResizePolicy resizePolicy = ResizePolicy::Fixed, const BackingPolicy backingPolicy = BackingPolicy::Heap);
 
 		~FreeListAllocator();
 
-		void* Allocate(const Size size, const Size alignment = 8, const char* name = "");
+		// Returns nullptr when a fixed size allocator is out of memory
+		void* Allocate(const Size size, const Size alignment = 8, const AllocationTag tag = AllocationTag());
 
 		template <typename Object, typename... Args>
 		Object* New(Args... argList);
 
-		void Deallocate(void* ptr, const char* name = "");
+		void Deallocate(void* ptr, const AllocationTag tag = AllocationTag());
+
+		/**
+		 * @brief Allocates many blocks of the same size at once
+		 * @details The blocks are carved one after another out of a single free block, so the index is searched
+		 * once and the statistics are updated once for the whole batch. If no free block can hold the batch, the
+		 * blocks are allocated one by one instead.
+		 *
+		 * @param ptrs Receives the address of every allocation
+		 * @param count The number of allocations
+		 * @return Size The number of allocations made, less than count only if a fixed size allocator is full
+		 */
+		Size AllocateN(void** ptrs, const Size count, const Size size, const Size alignment = 8, const AllocationTag tag = AllocationTag());
+
+		template <typename Object, typename... Args>
+		Size NewN(Object** objects, const Size count, Args... argList);
+
+		/**
+		 * @brief Deallocates many allocations at once
+		 * @details Allocations that sit next to each other, such as those of one AllocateN call, are merged into
+		 * one free block before it enters the index, so freeing them costs about as much as freeing a single one.
+		 *
+		 * @param ptrs The allocations to free. They are sorted by address in place.
+		 */
+		void DeallocateN(void** ptrs, const Size count, const AllocationTag tag = AllocationTag());
+
+		/**
+		 * @brief Grows or shrinks an allocation without moving it. Growing only works if the block after it is
+		 * free and large enough. Shrinking always works, and gives the rest of the block back.
+		 *
+		 * @param newSize The new size of the data, the alignment of the allocation does not change
+		 * @return bool False if the allocation could not grow, in which case it is left untouched
+		 */
+		bool TryExpand(void* ptr, const Size newSize, const AllocationTag tag = AllocationTag());
+
+		/**
+		 * @brief Resizes an allocation in place if possible, and moves it to a new block otherwise
+		 *
+		 * @return void* The new address of the data, or nullptr if a fixed size allocator is out of memory. The
+		 * old allocation stays valid in that case.
+		 */
+		void* Reallocate(void* ptr, const Size newSize, const Size alignment = 8, const AllocationTag tag = AllocationTag());
 
 		template <typename Object>
 		void Delete(Object* ptr);
 
+		// Calls the destructor of every object, then deallocates them all at once. Sorts the objects by address.
+		template <typename Object>
+		void DeleteN(Object** objects, const Size count);
+
 		void Init();
 
+		// Also gives every region except the first one back to the OS
 		void Reset();
 
+		// Gives the regions that have been empty for at least the region idle time back to the OS. The first
+		// region is never released. Call this regularly, for example once per frame.
+		void ReleaseIdleRegions();
+
+		inline void SetRegionIdleTime(std::chrono::milliseconds idleTime) { m_RegionIdleTime = idleTime; }
+
 		inline Size GetUsedSize() const { return m_Data->UsedSize; }
+		inline Size GetTotalSize() const { return m_Data->TotalSize; }
+		inline Size GetCommittedSize() const { return m_Data->CommittedSize; }
+		inline const AllocatorData& GetAllocatorData() const { return *m_Data; }
 
 	  private:
+		friend class ThreadCachedAllocator;
+
 		FreeListAllocator(FreeListAllocator& freeListAllocator);
 
-		void Coalescence(Node* prevBlock, Node* freeBlock);
+		static inline Size GetBlockSize(const BlockHeader* block) { return block->sizeAndFlags & ~BLOCK_FLAGS; }
+		static Size GetBlockPadding(const Size blockAddress, const Size alignment);
+
+		static inline DecommittedSpan* GetDecommittedSpan(const Size blockAddress, const Size blockSize)
+		{
+			return (DecommittedSpan*)(blockAddress + blockSize - sizeof(Size) - sizeof(DecommittedSpan));
+		}
+		void DecommitBlock(FreeBlockHeader* block);
+
+		// Merges a block that is no longer in use with its free neighbours and adds the result to the index
+		void ReleaseBlock(Size blockAddress, Size blockSize);
+
+		// Shrinks a block that has been taken out of the index to the required size, and gives the tail back
+		// if it can hold a free block. Returns the final size of the block.
+		Size SplitBlock(const Size blockAddress, const Size blockSize, const Size requiredSize, DecommittedSpan span);
+
+		// Turns a region into one free block followed by the end marker
+		FreeBlockHeader* InitRegion(void* startPtr, const Size size);
+		FreeBlockHeader* AddRegion(const Size size, const Size alignment);
+		void ReleaseRegion(Region& region);
+
+		FreeBlockHeader* FindFreeBlock(const Size size, const Size alignment);
+		void InsertFreeBlock(FreeBlockHeader* block);
+		void RemoveFreeBlock(FreeBlockHeader* block);
+		// Keep the sizes of the largest free blocks up to date as blocks enter and leave the index
+		void TrackLargestBlock(const Size blockSize);
+		void UntrackLargestBlock(const Size blockSize);
+		void InsertLargestBlock(const Size blockSize);
+		// Searches the index for the largest free blocks, once none of them are tracked anymore
+		void FindLargestBlocks();
+
+		FreeBlockHeader* FindInList(const Size size, const Size alignment) const;
+		void InsertInList(FreeBlockHeader* block);
+		void RemoveFromList(FreeBlockHeader* block);
 
-		void Find(const Size size, const Size alignment, Size& padding, Node*& previousNode, Node*& foundNode);
-		void FindBest(const Size size, const Size alignment, Size& padding, Node*& previousNode, Node*& foundNode);
-		void FindFirst(const Size size, const Size alignment, Size& padding, Node*& previousNode, Node*& foundNode);
+		FreeBlockHeader* FindInSizeTree(const Size size, const Size alignment) const;
+		static FreeBlockHeader* InsertInSizeTree(FreeBlockHeader* root, FreeBlockHeader* block);
+		static FreeBlockHeader* RemoveFromSizeTree(FreeBlockHeader* root, FreeBlockHeader* block);
+		static FreeBlockHeader* RemoveMinimumFromSizeTree(FreeBlockHeader* root);
+		static FreeBlockHeader* BalanceSizeTree(FreeBlockHeader* root);
+
+		static void MapSegregated(const Size blockSize, Size& firstLevel, Size& secondLevel);
+		FreeBlockHeader* FindSegregated(const Size blockSize);
+		void InsertSegregated(FreeBlockHeader* block);
+		void RemoveSegregated(FreeBlockHeader* block);
 
 	  private:
 		void* m_StartPtr = nullptr;
 		PlacementPolicy m_Policy;
-		SinglyLinkedList<FreeHeader> m_FreeList;
+		ResizePolicy m_ResizePolicy;
+		BackingPolicy m_BackingPolicy;
+		Size m_DecommitGranularity;
+		Size m_RegionSize;
 		std::shared_ptr<AllocatorData> m_Data;
+		// Off when the allocations are tracked by the allocator that owns this one
+		bool m_Tracked = true;
+
+		// Regions mapped after the first one
+		std::vector<Region> m_Regions;
+		std::chrono::milliseconds m_RegionIdleTime{5000};
+
+		// Free list, in no particular order
+		FreeBlockHeader* m_FreeListHead = nullptr;
+
+		// Size tree, ordered by block size and then by address so every key is unique
+		FreeBlockHeader* m_SizeTreeRoot = nullptr;
+
+		// Sizes of the largest free blocks, in descending order. Untracked free blocks are never larger than
+		// the smallest tracked one, so the index is only searched when all the tracked blocks are gone.
+		Size m_LargestBlocks[TRACKED_LARGEST_BLOCKS] = {};
+		Size m_LargestBlockCount = 0;
+
+		// Segregated index. A set bit in m_FirstLevelBitmap means that row has at least one non-empty bin, a
+		// set bit in m_SecondLevelBitmaps[row] means that bin has at least one free block.
+		UInt64 m_FirstLevelBitmap = 0;
+		UInt32 m_SecondLevelBitmaps[SEGREGATED_FL_COUNT] = {};
+		FreeBlockHeader* m_SegregatedBins[SEGREGATED_FL_COUNT][SEGREGATED_SL_COUNT] = {};
 	};
 
 	template <typename Object, typename... Args>
 	Object* FreeListAllocator::New(Args... argList)
 	{
 		void* address = Allocate(sizeof(Object)); // Allocate the raw memory and get a pointer to it
-		return new (address) Object(argList...);  //Call the placement new operator, which constructs the Object
+		// Nothing is constructed when the allocator is out of memory
+		return address == nullptr ? nullptr : new (address) Object(argList...);
 	}
 
 	template <typename Object>
@@ -81,4 +276,25 @@ namespace QMBT
 		ptr->~Object();	 // Call the destructor on the object
 		Deallocate(ptr); // Deallocate the pointer
 	}
+
+	template <typename Object, typename... Args>
+	Size FreeListAllocator::NewN(Object** objects, const Size count, Args... argList)
+	{
+		const Size allocatedCount = AllocateN((void**)objects, count, sizeof(Object), std::max<Size>(alignof(Object), 8));
+		for (Size i = 0; i < allocatedCount; i++)
+		{
+			new (objects[i]) Object(argList...);
+		}
+		return allocatedCount;
+	}
+
+	template <typename Object>
+	void FreeListAllocator::DeleteN(Object** objects, const Size count)
+	{
+		for (Size i = 0; i < count; i++)
+		{
+			objects[i]->~Object();
+		}
+		DeallocateN((void**)objects, count);
+	}
 } // namespace QMBT
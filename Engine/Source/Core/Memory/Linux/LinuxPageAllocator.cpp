@@ -0,0 +1,145 @@
+#include "QMBTPCH.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../PageAllocator.hpp"
+#include "../Utility/MemoryUtils.hpp"
+#include "Core/Logging/Logger.hpp"
+
+namespace QMBT
+{
+	namespace
+	{
+		constexpr Size s_HugePageSize = 2_MB;
+
+		Size GetPageSize()
+		{
+			static const Size s_PageSize = sysconf(_SC_PAGESIZE);
+			return s_PageSize;
+		}
+
+		Size GetMappingSize(const Size size, const BackingPolicy policy)
+		{
+			return Utility::AlignForward(size, policy == BackingPolicy::Pages ? GetPageSize() : s_HugePageSize);
+		}
+
+		void* MapTransparentHugePages(const Size mappingSize)
+		{
+			// Over-map so the region can start on a huge page boundary, then cut off the ends
+			const Size overMappedSize = mappingSize + s_HugePageSize;
+			void* ptr = mmap(nullptr, overMappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (ptr == MAP_FAILED)
+			{
+				return nullptr;
+			}
+
+			const Size start = (Size)ptr;
+			const Size alignedStart = Utility::AlignForward(start, s_HugePageSize);
+			if (alignedStart > start)
+			{
+				munmap(ptr, alignedStart - start);
+			}
+			if (start + overMappedSize > alignedStart + mappingSize)
+			{
+				munmap((void*)(alignedStart + mappingSize), start + overMappedSize - alignedStart - mappingSize);
+			}
+
+			madvise((void*)alignedStart, mappingSize, MADV_HUGEPAGE);
+			return (void*)alignedStart;
+		}
+	} // namespace
+
+	void* PageAllocator::Map(const Size size, const BackingPolicy policy)
+	{
+		if (policy == BackingPolicy::Heap)
+		{
+			return malloc(size);
+		}
+
+		const Size mappingSize = GetMappingSize(size, policy);
+
+		switch (policy)
+		{
+		case BackingPolicy::Pages:
+		{
+			void* ptr = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			return ptr == MAP_FAILED ? nullptr : ptr;
+		}
+		case BackingPolicy::HugeTLB:
+		{
+			void* ptr = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (ptr != MAP_FAILED)
+			{
+				return ptr;
+			}
+
+			LOG_MEMORY_WARN("Not enough reserved huge pages for {0} bytes, using transparent huge pages", mappingSize);
+			return MapTransparentHugePages(mappingSize);
+		}
+		case BackingPolicy::TransparentHugePages:
+			return MapTransparentHugePages(mappingSize);
+		default:
+			return nullptr;
+		}
+	}
+
+	void PageAllocator::Unmap(void* ptr, const Size size, const BackingPolicy policy)
+	{
+		if (policy == BackingPolicy::Heap)
+		{
+			free(ptr);
+			return;
+		}
+
+		munmap(ptr, GetMappingSize(size, policy));
+	}
+
+	void PageAllocator::Decommit(void* ptr, const Size size, const BackingPolicy policy)
+	{
+		if (policy == BackingPolicy::Heap || size == 0)
+		{
+			return;
+		}
+
+		madvise(ptr, size, MADV_DONTNEED);
+	}
+
+	void* PageAllocator::Reserve(const Size size)
+	{
+		// Inaccessible pages are not charged against the overcommit limit, so any amount of address space can be reserved
+		void* ptr = mmap(nullptr, GetMappingSize(size, BackingPolicy::Pages), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		return ptr == MAP_FAILED ? nullptr : ptr;
+	}
+
+	bool PageAllocator::Commit(void* ptr, const Size size)
+	{
+		return size == 0 || mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+	}
+
+	void PageAllocator::Uncommit(void* ptr, const Size size)
+	{
+		if (size == 0)
+		{
+			return;
+		}
+
+		madvise(ptr, size, MADV_DONTNEED);
+		mprotect(ptr, size, PROT_NONE);
+	}
+
+	Size PageAllocator::GetDecommitGranularity(const BackingPolicy policy)
+	{
+		switch (policy)
+		{
+		case BackingPolicy::Pages:
+			return GetPageSize();
+		case BackingPolicy::TransparentHugePages:
+		case BackingPolicy::HugeTLB:
+			// Decommitting less than a huge page would split it
+			return s_HugePageSize;
+		default:
+			return 0;
+		}
+	}
+} // namespace QMBT
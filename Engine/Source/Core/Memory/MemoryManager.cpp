@@ -24,7 +24,9 @@ namespace QMBT
 
 	void MemoryManager::Register(std::shared_ptr<AllocatorData> allocatorData)
 	{
-		m_TotalAllocatedSize += allocatorData->TotalSize;
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		const Int64 totalAllocatedSize = m_TotalAllocatedSize.fetch_add(allocatorData->TotalSize, std::memory_order_relaxed) + allocatorData->TotalSize;
 
 		// LOG_MEMORY_INFO("Registering {0} of total size {1}",
 		// 				allocatorData->DebugName,
@@ -32,15 +34,17 @@ namespace QMBT
 		// LOG_MEMORY_INFO("Total size allocated increased to {0}. Total budget left is {1}",
 		// 				Utility::ToReadable(m_TotalAllocatedSize),
 		// 				Utility::ToReadable(m_ApplicationBudget - m_TotalAllocatedSize));
-		QMBT_BARE_ASSERT(m_TotalAllocatedSize < m_ApplicationBudget, "Exceeded application memory budget!");
+		QMBT_BARE_ASSERT(static_cast<Size>(totalAllocatedSize) < m_ApplicationBudget, "Exceeded application memory budget!");
 		m_Allocators.push_back(allocatorData);
 	}
 
 	void MemoryManager::UnRegister(std::shared_ptr<AllocatorData> allocatorData)
 	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
 		m_Allocators.erase(std::remove(m_Allocators.begin(), m_Allocators.end(), allocatorData), m_Allocators.end());
 
-		m_TotalAllocatedSize -= allocatorData->TotalSize;
+		m_TotalAllocatedSize.fetch_sub(allocatorData->TotalSize, std::memory_order_relaxed);
 
 		// LOG_MEMORY_INFO("UnRegistering {0} of total size {1}",
 		// 				allocatorData->DebugName,
@@ -50,14 +54,35 @@ namespace QMBT
 		// 				Utility::ToReadable(m_ApplicationBudget - m_TotalAllocatedSize));
 	}
 
+	AllocatorVector MemoryManager::GetAllocators() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Allocators;
+	}
+
 	Size MemoryManager::GetUsedAllocatedSize() const
 	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
 		Size usedSize = 0;
 		for (const auto& it : m_Allocators)
 		{
-			usedSize += it->UsedSize;
+			usedSize += it->UsedSize.load(std::memory_order_relaxed);
 		}
 
 		return usedSize;
 	}
+
+	Size MemoryManager::GetCommittedAllocatedSize() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Size committedSize = 0;
+		for (const auto& it : m_Allocators)
+		{
+			committedSize += it->CommittedSize;
+		}
+
+		return committedSize;
+	}
 } // namespace QMBT
\ No newline at end of file
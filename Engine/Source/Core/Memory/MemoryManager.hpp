@@ -16,20 +16,27 @@ namespace QMBT
 
 		static MemoryManager& GetInstance();
 
+		// Allocators may be registered from any thread, such as the scratch arena of a worker thread
 		void Register(std::shared_ptr<AllocatorData> allocatorData);
 		void UnRegister(std::shared_ptr<AllocatorData> allocatorData);
 
-		inline void UpdateTotalSize(Size size) { m_TotalAllocatedSize += size; }
+		// Called by allocators that grow or shrink on any thread, such as multithreaded pools
+		inline void UpdateTotalSize(Int64 size) { m_TotalAllocatedSize.fetch_add(size, std::memory_order_relaxed); }
 
 		Size GetUsedAllocatedSize() const;
-		inline Size GetTotalAllocatedSize() const { return m_TotalAllocatedSize; }
+		// Backed by physical memory, at most the total allocated size
+		Size GetCommittedAllocatedSize() const;
+		// Reserved by all the allocators, whether it is backed by physical memory or not
+		inline Size GetTotalAllocatedSize() const { return static_cast<Size>(m_TotalAllocatedSize.load(std::memory_order_relaxed)); }
 		inline Size GetApplicationMemoryBudget() const { return m_ApplicationBudget; }
-		inline const AllocatorVector& GetAllocators() const { return m_Allocators; }
+		// A copy, so it stays valid while other threads register allocators
+		AllocatorVector GetAllocators() const;
 
 	  private:
 		AllocatorVector m_Allocators;
+		mutable std::mutex m_Mutex; // Guards m_Allocators
 
 		Size m_ApplicationBudget;
-		Size m_TotalAllocatedSize;
+		std::atomic<Int64> m_TotalAllocatedSize; // Shared by every allocator, so it is updated without m_Mutex
 	};
 } // namespace QMBT
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "AllocationTags.hpp"
+#include "Core/Aliases.hpp"
+#include "Core/Core.hpp"
+
+namespace QMBT
+{
+	class StackAllocator;
+	class FrameAllocator;
+	class DoubleBufferedAllocator;
+	class ScratchArena;
+	class VirtualArena;
+
+	/**
+	 * @brief Where an STLAllocator gets its memory from, when it is not the global small object allocator
+	 * @details Any engine allocator can be wrapped in an AllocatorResource and handed to an STLAllocator, so a
+	 * container can be pointed at a frame arena, a pool or a per-thread heap without changing its type.
+	 *
+	 */
+	class MemoryResource
+	{
+	  public:
+		virtual ~MemoryResource() = default;
+
+		virtual void* Allocate(const Size size, const Size alignment, const AllocationTag tag) = 0;
+		virtual void Deallocate(void* ptr, const Size size, const AllocationTag tag) = 0;
+
+		// Resizes an allocation without moving it, returns false if it was left untouched
+		virtual bool TryExpand(void* ptr, const Size size, const Size newSize, const AllocationTag tag) { return false; }
+
+		// Resizes an allocation in place if possible, and moves its bytes to a new one otherwise
+		virtual void* Reallocate(void* ptr, const Size size, const Size newSize, const Size alignment, const AllocationTag tag)
+		{
+			if (TryExpand(ptr, size, newSize, tag))
+			{
+				return ptr;
+			}
+
+			void* newPtr = Allocate(newSize, alignment, tag);
+			if (newPtr != nullptr)
+			{
+				memcpy(newPtr, ptr, std::min(size, newSize));
+				Deallocate(ptr, size, tag);
+			}
+			return newPtr;
+		}
+	};
+
+	/**
+	 * @brief Allocators that only free everything at once, by a marker or a reset
+	 * @details An AllocatorResource drops the deallocations of these allocators. Every other allocator has to
+	 * be able to free a single block, so a new allocator is never leaked into by accident.
+	 */
+	template <typename Allocator>
+	struct IsLinearAllocator : std::false_type
+	{
+	};
+
+	template <>
+	struct IsLinearAllocator<StackAllocator> : std::true_type
+	{
+	};
+
+	template <>
+	struct IsLinearAllocator<FrameAllocator> : std::true_type
+	{
+	};
+
+	template <>
+	struct IsLinearAllocator<DoubleBufferedAllocator> : std::true_type
+	{
+	};
+
+	template <>
+	struct IsLinearAllocator<ScratchArena> : std::true_type
+	{
+	};
+
+	template <>
+	struct IsLinearAllocator<VirtualArena> : std::true_type
+	{
+	};
+
+	namespace Detail
+	{
+		template <typename>
+		struct AlwaysFalse : std::false_type
+		{
+		};
+
+		// PoolAllocator, which hands out chunks of a single size
+		template <typename Allocator, typename = void>
+		struct IsPoolAllocator : std::false_type
+		{
+		};
+
+		template <typename Allocator>
+		struct IsPoolAllocator<Allocator, std::void_t<typename Allocator::ObjectType, decltype(std::declval<Allocator&>().Allocate(AllocationTag()))>> : std::true_type
+		{
+		};
+
+		template <typename Allocator, typename = void>
+		struct HasTaggedAllocate : std::false_type
+		{
+		};
+
+		template <typename Allocator>
+		struct HasTaggedAllocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().Allocate(Size(0), Size(0), AllocationTag()))>> : std::true_type
+		{
+		};
+
+		// SmallObjectAllocator and ThreadCachedAllocator
+		template <typename Allocator, typename = void>
+		struct HasSizedDeallocate : std::false_type
+		{
+		};
+
+		template <typename Allocator>
+		struct HasSizedDeallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().Deallocate((void*)nullptr, Size(0), AllocationTag()))>> : std::true_type
+		{
+		};
+
+		// FreeListAllocator
+		template <typename Allocator, typename = void>
+		struct HasUnsizedDeallocate : std::false_type
+		{
+		};
+
+		template <typename Allocator>
+		struct HasUnsizedDeallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().Deallocate((void*)nullptr, AllocationTag()))>> : std::true_type
+		{
+		};
+
+		// PolicyAllocator
+		template <typename Allocator, typename = void>
+		struct HasUntaggedDeallocate : std::false_type
+		{
+		};
+
+		template <typename Allocator>
+		struct HasUntaggedDeallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().Deallocate((void*)nullptr, Size(0)))>> : std::true_type
+		{
+		};
+
+		template <typename Allocator, typename = void>
+		struct HasSizedTryExpand : std::false_type
+		{
+		};
+
+		template <typename Allocator>
+		struct HasSizedTryExpand<Allocator, std::void_t<decltype(std::declval<Allocator&>().TryExpand(nullptr, Size(0), Size(0), AllocationTag()))>> : std::true_type
+		{
+		};
+
+		template <typename Allocator, typename = void>
+		struct HasUnsizedTryExpand : std::false_type
+		{
+		};
+
+		template <typename Allocator>
+		struct HasUnsizedTryExpand<Allocator, std::void_t<decltype(std::declval<Allocator&>().TryExpand(nullptr, Size(0), AllocationTag()))>> : std::true_type
+		{
+		};
+	} // namespace Detail
+
+	/**
+	 * @brief Exposes an engine allocator as a MemoryResource
+	 * @details Allocators that can free single blocks, such as FreeListAllocator, ThreadCachedAllocator,
+	 * SmallObjectAllocator and PolicyAllocator, get every deallocation. The deallocations of an IsLinearAllocator,
+	 * such as FrameAllocator, DoubleBufferedAllocator, ScratchArena and VirtualArena, are dropped, so a container
+	 * costs nothing to free and its memory comes back when the allocator is reset. A container on a linear
+	 * allocator must not be used after that reset.
+	 *
+	 * A PoolAllocator only hands out chunks of its object size, so it suits containers that allocate one node
+	 * at a time, such as lists and maps, and never a container that grows a buffer.
+	 *
+	 * @tparam Allocator Any engine allocator with Allocate(size, alignment), or a PoolAllocator
+	 */
+	template <typename Allocator>
+	class AllocatorResource final : public MemoryResource
+	{
+	  public:
+		explicit AllocatorResource(Allocator& allocator)
+			: m_Allocator(allocator)
+		{
+		}
+
+		void* Allocate(const Size size, const Size alignment, const AllocationTag tag) override
+		{
+			if constexpr (Detail::IsPoolAllocator<Allocator>::value)
+			{
+				QMBT_CORE_ASSERT(size <= m_Allocator.GetChunkSize(), "Allocation is larger than the chunks of the pool!");
+				QMBT_CORE_ASSERT(alignment <= m_Allocator.GetChunkAlignment(), "Alignment is larger than the alignment of the pool!");
+				return m_Allocator.Allocate(tag);
+			}
+			else if constexpr (Detail::HasTaggedAllocate<Allocator>::value)
+			{
+				return m_Allocator.Allocate(size, alignment, tag);
+			}
+			else
+			{
+				return m_Allocator.Allocate(size, alignment);
+			}
+		}
+
+		void Deallocate(void* ptr, const Size size, const AllocationTag tag) override
+		{
+			if constexpr (Detail::IsPoolAllocator<Allocator>::value)
+			{
+				m_Allocator.Deallocate(static_cast<typename Allocator::ObjectType*>(ptr), tag);
+			}
+			else if constexpr (Detail::HasSizedDeallocate<Allocator>::value)
+			{
+				m_Allocator.Deallocate(ptr, size, tag);
+			}
+			else if constexpr (Detail::HasUnsizedDeallocate<Allocator>::value)
+			{
+				m_Allocator.Deallocate(ptr, tag);
+			}
+			else if constexpr (Detail::HasUntaggedDeallocate<Allocator>::value)
+			{
+				m_Allocator.Deallocate(ptr, size);
+			}
+			else if constexpr (!IsLinearAllocator<Allocator>::value)
+			{
+				static_assert(Detail::AlwaysFalse<Allocator>::value, "The allocator cannot free a single block and is not an IsLinearAllocator");
+			}
+		}
+
+		bool TryExpand(void* ptr, const Size size, const Size newSize, const AllocationTag tag) override
+		{
+			if constexpr (Detail::HasSizedTryExpand<Allocator>::value)
+			{
+				return m_Allocator.TryExpand(ptr, size, newSize, tag);
+			}
+			else if constexpr (Detail::HasUnsizedTryExpand<Allocator>::value)
+			{
+				return m_Allocator.TryExpand(ptr, newSize, tag);
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		inline Allocator& GetAllocator() { return m_Allocator; }
+
+	  private:
+		Allocator& m_Allocator;
+	};
+} // namespace QMBT
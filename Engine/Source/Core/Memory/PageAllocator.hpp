@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "AllocatorData.hpp"
+#include "Core/Aliases.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief Gets the regions of the allocators from the OS, and gives unused spans of them back.
+	 * @details BackingPolicy::Heap uses malloc and never decommits anything. The other policies map anonymous
+	 * pages, which the OS only backs with physical memory once they are touched.
+	 *
+	 */
+	class PageAllocator
+	{
+	  public:
+		/**
+		 * @brief Maps a region of at least the given size
+		 *
+		 * @return void* The start of the region, or nullptr if it could not be mapped
+		 */
+		static void* Map(const Size size, const BackingPolicy policy);
+
+		/**
+		 * @brief Unmaps a region returned by Map
+		 *
+		 * @param size The size that was passed to Map
+		 */
+		static void Unmap(void* ptr, const Size size, const BackingPolicy policy);
+
+		/**
+		 * @brief Gives the physical memory behind a span back to the OS. The span keeps its addresses, and
+		 * reads as zeroes the next time it is touched.
+		 *
+		 * @param ptr Must be aligned to the decommit granularity
+		 * @param size Must be a multiple of the decommit granularity
+		 */
+		static void Decommit(void* ptr, const Size size, const BackingPolicy policy);
+
+		/**
+		 * @brief The smallest span that can be decommitted without splitting a page
+		 *
+		 * @return Size 0 if the policy cannot decommit at all
+		 */
+		static Size GetDecommitGranularity(const BackingPolicy policy);
+
+		/**
+		 * @brief Reserves a region of address space without backing any of it. The region cannot be touched
+		 * before a span of it is committed, and is given back with Unmap and BackingPolicy::Pages.
+		 *
+		 * @return void* The start of the region, or nullptr if the address space is not available
+		 */
+		static void* Reserve(const Size size);
+
+		/**
+		 * @brief Makes a span of a reserved region usable. The OS backs each page once it is touched.
+		 *
+		 * @param ptr Must be aligned to the page size
+		 * @param size Must be a multiple of the page size
+		 * @return bool false if the OS is out of memory
+		 */
+		static bool Commit(void* ptr, const Size size);
+
+		// Gives a committed span back to the OS and makes it inaccessible again, with the same constraints as Commit
+		static void Uncommit(void* ptr, const Size size);
+	};
+} // namespace QMBT
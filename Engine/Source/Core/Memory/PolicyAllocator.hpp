@@ -0,0 +1,148 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "AllocatorPolicies.hpp"
+#include "Core/CoreConfig.hpp"
+#include "SmallObjectAllocator.hpp"
+
+namespace QMBT
+{
+	// Backing allocators. A backing allocator only has to provide Allocate(size, alignment) and Deallocate(ptr, size).
+
+	// malloc, for allocators that should not depend on the engine heap
+	struct HeapBacking
+	{
+		inline void* Allocate(const Size size, const Size alignment)
+		{
+			// aligned_alloc only takes sizes that are a multiple of the alignment
+			return std::aligned_alloc(alignment, Utility::AlignForward(size, alignment));
+		}
+		inline void Deallocate(void* ptr, const Size size) { std::free(ptr); }
+	};
+
+	// The global small object allocator that STLAllocator uses
+	struct GlobalBacking
+	{
+		inline void* Allocate(const Size size, const Size alignment) { return GetSmallObjectAllocator()->Allocate(size, alignment); }
+		inline void Deallocate(void* ptr, const Size size) { GetSmallObjectAllocator()->Deallocate(ptr, size); }
+	};
+
+	/**
+	 * @brief An allocator composed at compile time from a backing allocator and a set of policies.
+	 * @details Every hook of a policy is called on each allocation, and the disabled policies are empty structs
+	 * with empty inline hooks. A disabled policy therefore adds neither size nor instructions, and with every policy
+	 * disabled the allocator is exactly its backing allocator. The Default policies are switched on by
+	 * QMBT_MEMORY_DIAGNOSTICS, so an allocator declared with them is tracked in diagnostics builds and is free otherwise.
+	 *
+	 * The policies are base classes, so they can be empty. Policies with state, such as the AllocatorData of
+	 * AllocatorStatistics, can be reached through the allocator.
+	 *
+	 * @tparam Backing Where the memory comes from, see HeapBacking
+	 * @tparam Locking NoLocking or MutexLocking. Guards the backing allocator and every other policy.
+	 * @tparam Statistics NoStatistics or AllocatorStatistics
+	 * @tparam BoundsChecking NoBoundsChecking or GuardBoundsChecking
+	 * @tparam Logging NoLogging or MemoryLogging
+	 */
+	template <typename Backing, typename Locking = NoLocking, typename Statistics = DefaultStatistics,
+			  typename BoundsChecking = DefaultBoundsChecking, typename Logging = DefaultLogging>
+	class PolicyAllocator : private Backing, public Locking, public Statistics, public BoundsChecking, public Logging
+	{
+	  public:
+		//Prohibit copying, the statistics are registered once per allocator
+		PolicyAllocator(const PolicyAllocator&) = delete;
+		PolicyAllocator& operator=(const PolicyAllocator&) = delete;
+
+		/**
+		 * @brief Construct a new Policy Allocator object.
+		 *
+		 * @param debugName The name that will appear in logs and any editor
+		 * @param backingArgs Passed to the constructor of the backing allocator
+		 */
+		template <typename... Args>
+		explicit PolicyAllocator(const char* debugName = "PolicyAllocator", Args&&... backingArgs)
+			: Backing(std::forward<Args>(backingArgs)...)
+		{
+			Statistics::Initialize(debugName);
+			BoundsChecking::Initialize(debugName);
+			Logging::Initialize(debugName);
+		}
+
+		~PolicyAllocator() { Statistics::Shutdown(); }
+
+		/**
+		 * @brief Allocates raw memory from the backing allocator
+		 *
+		 * @param alignment At least 8, and at most BoundsChecking::FRONT_GUARD_SIZE if that is not 0
+		 * @return void* nullptr if the backing allocator is out of memory
+		 */
+		void* Allocate(const Size size, const Size alignment = 8);
+
+		// The size must be the one the block was allocated with
+		void Deallocate(void* ptr, const Size size);
+
+		template <typename Object, typename... Args>
+		Object* New(Args&&... argList)
+		{
+			// Backing allocators only take alignments of at least 8, see Allocate
+			void* address = Allocate(sizeof(Object), std::max<Size>(alignof(Object), 8));
+			return new (address) Object(std::forward<Args>(argList)...);
+		}
+
+		template <typename Object>
+		void Delete(Object* ptr)
+		{
+			ptr->~Object();
+			Deallocate(ptr, sizeof(Object));
+		}
+
+		inline Backing& GetBacking() { return *this; }
+
+	  private:
+		struct LockGuard
+		{
+			Locking& locking;
+			LockGuard(Locking& _locking)
+				: locking(_locking) { locking.Lock(); }
+			~LockGuard() { locking.Unlock(); }
+		};
+	};
+
+	template <typename Backing, typename Locking, typename Statistics, typename BoundsChecking, typename Logging>
+	void* PolicyAllocator<Backing, Locking, Statistics, BoundsChecking, Logging>::Allocate(const Size size, const Size alignment)
+	{
+		QMBT_CORE_ASSERT(alignment >= 8, "Alignment must be at least 8!");
+		QMBT_CORE_ASSERT(BoundsChecking::FRONT_GUARD_SIZE == 0 || alignment <= BoundsChecking::FRONT_GUARD_SIZE,
+						 "Alignment is larger than the front guard!");
+
+		LockGuard lock(*this);
+
+		UInt8* front = (UInt8*)Backing::Allocate(BoundsChecking::FRONT_GUARD_SIZE + size + BoundsChecking::BACK_GUARD_SIZE, alignment);
+		if (front == nullptr)
+		{
+			return nullptr;
+		}
+
+		BoundsChecking::WriteGuards(front, size);
+
+		void* ptr = front + BoundsChecking::FRONT_GUARD_SIZE;
+		Statistics::OnAllocate(ptr, size);
+		Logging::OnAllocate(size);
+
+		return ptr;
+	}
+
+	template <typename Backing, typename Locking, typename Statistics, typename BoundsChecking, typename Logging>
+	void PolicyAllocator<Backing, Locking, Statistics, BoundsChecking, Logging>::Deallocate(void* ptr, const Size size)
+	{
+		LockGuard lock(*this);
+
+		UInt8* front = (UInt8*)ptr - BoundsChecking::FRONT_GUARD_SIZE;
+
+		Logging::OnDeallocate(size);
+		Statistics::OnDeallocate(ptr, size);
+		BoundsChecking::CheckGuards(front, size);
+
+		Backing::Deallocate(front, BoundsChecking::FRONT_GUARD_SIZE + size + BoundsChecking::BACK_GUARD_SIZE);
+	}
+} // namespace QMBT
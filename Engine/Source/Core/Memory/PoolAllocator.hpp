@@ -2,6 +2,8 @@
 
 #include <QMBTPCH.hpp>
 
+#include "Core/Memory/AllocationTracker.hpp"
+#include "Core/Memory/AllocatorPolicies.hpp"
 #include "Core/Memory/MemoryManager.hpp"
 #include "Core/Types/BasicVector.hpp"
 
@@ -11,13 +13,37 @@ namespace QMBT
 	/**
 	 * @brief A templated allocator that can only be used to allocate memory for a 
 	 * collection of the same type. 
+	 * @details Chunks that have never been used are handed out by bumping a cursor through the newest block,
+	 * and only freed chunks are kept in a free list. Adding a block therefore never touches its memory, and a
+	 * page of a large block is only touched once a chunk in it is first allocated.
+	 *
+	 * With ThreadingPolicy::MultiThreaded, any thread may allocate and free, including chunks another thread
+	 * allocated. The free list is then a lock-free stack. Only a thread that finds it empty takes a lock, to carve
+	 * a few fresh chunks from the cursor.
+	 *
+	 * A resizable pool can double the size of every block it adds, up to a cap, so a pool that keeps growing
+	 * needs few blocks. Blocks that are completely free can be given back with ReleaseEmptyBlocks. To know which
+	 * blocks are free, a single threaded resizable pool counts every chunk against its block, which is a binary
+	 * search through the blocks. A fixed size pool only has one block and needs no search.
+	 *
+	 * Every chunk is aligned to Alignment, and with PaddingPolicy::CacheLine it fills whole cache lines and starts
+	 * on one, so objects handed to different threads never share a line. The padding is counted in UsedSize.
+	 *
+	 * The allocations are only counted and tracked with the DefaultStatistics policy, so UsedSize and the tagged
+	 * sizes stay 0 in a release build. The blocks are always counted. Adding a block is never logged, so a pool
+	 * can be used before the loggers are initialized, by a global allocator for example.
 	 * 
 	 * @tparam Object 
+	 * @tparam Alignment The alignment of every chunk. Can be raised above alignof(Object), for SIMD loads for example.
+	 * @tparam Logging NoLogging or MemoryLogging, logs every allocation and deallocation
 	 */
-	template <typename Object, ResizePolicy Policy = ResizePolicy::Fixed>
-	class PoolAllocator
+	template <typename Object, ResizePolicy Policy = ResizePolicy::Fixed, ThreadingPolicy Threading = ThreadingPolicy::SingleThreaded,
+			  Size Alignment = alignof(Object), typename Logging = DefaultLogging>
+	class PoolAllocator : private Logging
 	{
 	  public:
+		using ObjectType = Object;
+
 		//Prohibit default construction, moving and assignment
 		PoolAllocator(const PoolAllocator&) = delete;
 		PoolAllocator(PoolAllocator&&) = delete;
@@ -28,10 +54,14 @@ namespace QMBT
 		 * @brief Construct a new Pool Allocator object.
 		 * 
 		 * @param debugName The name that will appear in logs and any editor.
-		 * @param chunksPerBlock After this many items have been allocated, the allocator allocates
-		 * a new block of size equal to chunksPerBlock * sizeof(Object). 
+		 * @param blockSize After this many items have been allocated, the allocator allocates
+		 * a new block of size equal to blockSize * sizeof(Object). 
+		 * @param maxBlockSize A resizable pool makes every block it adds twice as large as the previous one,
+		 * until blocks have this many items. 0 keeps every block at blockSize items.
+		 * @param padding Whether each chunk is padded to whole cache lines
 		 */
-		PoolAllocator(const char* debugName = "Allocator", Size blockSize = 1);
+		PoolAllocator(const char* debugName = "Allocator", Size blockSize = 1, Size maxBlockSize = 0,
+					  const PaddingPolicy padding = PaddingPolicy::None);
 
 		/**
 		 * @brief Destroy the Pool Allocator object and frees all the allocated memory
@@ -42,13 +72,14 @@ namespace QMBT
 		/**
 		 * @brief Gets an address in the pool, constructs the object at the address and returns the address
 		 * 
-		 * @return Object* The pointer to the newly allocated memory
+		 * @param tag The name the allocation is counted under in AllocatorData::TaggedSizes
+		 * @return Object* The pointer to the newly allocated memory, or nullptr if a fixed size pool is full
 		 */
-		void* Allocate();
+		void* Allocate(const AllocationTag tag = AllocationTag());
 
 		/**
 		 * @brief Allocates a new block of memory and calls the constructor
-		 * @details Allocation complexity is O(1)
+		 * @details Allocation complexity is O(1), or O(log blocks) for a single threaded resizable pool
 		 * 
 		 * @tparam Object The type to be created
 		 * @tparam Args Variadic arguments
@@ -64,149 +95,574 @@ namespace QMBT
 
 		/**
 		 * @brief Deallocates raw memory without calling any destructor
-		 * @details Deallocation complexity is O(1)
+		 * @details Deallocation complexity is O(1), or O(log blocks) for a single threaded resizable pool
 		 * 
 		 * @param ptr The pointer to the memory to be deallocated
+		 * @param tag The tag it was allocated with
 		 */
-		void Deallocate(Object* ptr);
+		void Deallocate(Object* ptr, const AllocationTag tag = AllocationTag());
 
 		/**
 		 * @brief Deallocates a pointer and calls the destructor
-		 * @details Deallocation complexity is O(1)
+		 * @details Deallocation complexity is the same as Deallocate
 		 * 
 		 * @tparam Object The type of the passed pointer
 		 * @param ptr The pointer to the memory to be deallocated
 		 */
 		void Delete(Object* ptr);
 
-		inline Size GetUsedSize() const { return m_Data->UsedSize; }
+		/**
+		 * @brief Allocates raw memory for many objects at once
+		 * @details The statistics are updated once for the whole batch, and fresh chunks are taken from the
+		 * cursor a block at a time, so the cost per object is little more than writing its pointer.
+		 *
+		 * @param objects Receives the address of every chunk
+		 * @param count The number of chunks to allocate
+		 * @return Size The number of chunks that were allocated, less than count only if a fixed size pool is full
+		 */
+		Size AllocateN(Object** objects, const Size count);
+
+		/**
+		 * @brief Allocates many objects at once and constructs each of them with the same arguments
+		 *
+		 * @return Size The number of objects that were created, see AllocateN
+		 */
+		template <typename... Args>
+		Size NewN(Object** objects, const Size count, Args... argList)
+		{
+			const Size allocatedCount = AllocateN(objects, count);
+			for (Size i = 0; i < allocatedCount; i++)
+			{
+				new (objects[i]) Object(argList...);
+			}
+			return allocatedCount;
+		}
+
+		/**
+		 * @brief Deallocates many chunks at once without calling any destructor
+		 * @details The chunks are linked to each other and added to the free list in one go, which is a single
+		 * exchange for a MultiThreaded pool.
+		 */
+		void DeallocateN(Object** objects, const Size count);
+
+		// Calls the destructor of every object, then deallocates them all at once
+		void DeleteN(Object** objects, const Size count);
+
+		/**
+		 * @brief Frees the blocks that no object lives in anymore. Only for single threaded resizable pools.
+		 * @details Walks the whole free list, so call it once a burst of allocations is over rather than
+		 * after every deallocation.
+		 *
+		 * @return Size The number of blocks that were freed
+		 */
+		Size ReleaseEmptyBlocks();
+
+		inline Size GetUsedSize() const { return m_Data->UsedSize.load(std::memory_order_relaxed); }
+		inline Size GetTotalSize() const { return m_Data->TotalSize; }
+		inline Size GetBlockCount() const { return m_Blocks.size(); }
+		inline Size GetChunkSize() const { return m_ChunkSize; }
+		inline Size GetChunkAlignment() const { return m_ChunkAlignment; }
+		inline const AllocatorData& GetAllocatorData() const { return *m_Data; }
 
 	  private:
+		static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2");
+		static_assert(Alignment >= alignof(Object), "Alignment must be at least the alignment of the object");
+
 		PoolAllocator(PoolAllocator&);
-		Chunk* AllocateBlock(Size chunkSize);
+		// Makes a new block the one the cursor bumps through
+		void AllocateBlock(Size chunkSize);
+		// Index of the block a chunk belongs to, in m_Blocks and the pool blocks of m_Data. Always 0 for a fixed size pool.
+		Size FindBlock(const void* chunk) const;
+
+		// The upper bits of the shared free list head count how often it changed. A chunk that is popped and
+		// pushed back while another thread is popping it then does not look like the same head (ABA).
+		static constexpr UInt64 POINTER_BITS = 48;
+		static constexpr UInt64 POINTER_MASK = (UInt64(1) << POINTER_BITS) - 1;
+		// A thread that finds the shared free list empty carves this many bytes of fresh chunks at once
+		static constexpr Size SHARED_REFILL_SIZE = 4_KB;
+
+		static inline UInt64 PackHead(const Chunk* chunk, const UInt64 head)
+		{
+			return (UInt64)chunk | (((head >> POINTER_BITS) + 1) << POINTER_BITS);
+		}
+
+		Chunk* PopShared();
+		void PushShared(Chunk* first, Chunk* last);
 
 	  private:
 		// Declaration order is important
 		std::shared_ptr<AllocatorData> m_Data;
 
-		Size m_BlockSize;
+		Size m_BlockSize; // Items in the next block
+		Size m_MaxBlockSize;
 		Size m_ObjectSize;
+		Size m_ChunkSize;	   // The distance between two chunks, the object size with padding
+		Size m_ChunkAlignment; // Of the blocks, and therefore of every chunk
+
+		Chunk* m_FreeList = nullptr; // Chunks that have been freed, most recently freed first
+
+		// The chunks from the cursor up to the end of the newest block have never been allocated
+		char* m_Cursor = nullptr;
+		char* m_BlockEnd = nullptr;
+
+		std::vector<char*> m_Blocks; // In address order
 
-		Chunk* m_CurrentPtr = nullptr;
-		std::vector<Chunk*> m_AllocatedBlocks;
+		// Used instead of m_FreeList by a MultiThreaded pool. A tagged pointer, see PackHead. Every thread
+		// writes it, so it gets a cache line of its own.
+		alignas(64) std::atomic<UInt64> m_SharedFreeList{0};
+		// Guards the cursor and the blocks of a MultiThreaded pool
+		alignas(64) std::mutex m_Mutex;
 	};
 
-	template <typename Object, ResizePolicy Policy>
-	PoolAllocator<Object, Policy>::PoolAllocator(const char* debugName, Size blockSize)
-		: m_Data(std::make_shared<AllocatorData>(debugName, 0)), m_BlockSize(blockSize), m_ObjectSize(sizeof(Object)),
-		  m_CurrentPtr(AllocateBlock(m_ObjectSize))
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	PoolAllocator<Object, Policy, Threading, Alignment, Logging>::PoolAllocator(const char* debugName, Size blockSize, Size maxBlockSize,
+																	   const PaddingPolicy padding)
+		: m_Data(std::make_shared<AllocatorData>(debugName, 0)), m_BlockSize(blockSize), m_MaxBlockSize(std::max(maxBlockSize, blockSize)),
+		  m_ObjectSize(sizeof(Object)), m_ChunkSize(Utility::AlignForward(sizeof(Object), Alignment)), m_ChunkAlignment(Alignment)
 	{
 		QMBT_CORE_ASSERT(blockSize > 0, "Block size has to be more than 0!");
 
+		if (padding == PaddingPolicy::CacheLine)
+		{
+			// The line size cannot be read on some systems
+			const Size cacheLineSize = GetCacheLineSize() != 0 ? GetCacheLineSize() : 64;
+			m_ChunkSize = Utility::AlignForward(m_ChunkSize, cacheLineSize);
+			m_ChunkAlignment = std::max(m_ChunkAlignment, cacheLineSize);
+		}
+
 		MemoryManager::GetInstance()
 			.Register(m_Data);
+		Logging::Initialize(debugName);
 
-		m_AllocatedBlocks.push_back(m_CurrentPtr);
+		AllocateBlock(m_ChunkSize);
 	}
 
-	template <typename Object, ResizePolicy Policy>
-	PoolAllocator<Object, Policy>::~PoolAllocator()
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	PoolAllocator<Object, Policy, Threading, Alignment, Logging>::~PoolAllocator()
 	{
+		AllocationTracker::OnRelease(m_Data.get());
 		MemoryManager::GetInstance().UnRegister(m_Data);
-		for (auto& ptr : m_AllocatedBlocks)
+		for (auto& ptr : m_Blocks)
 		{
-			free(ptr);
+			::operator delete(ptr, std::align_val_t(m_ChunkAlignment));
 		}
 	}
 
-	template <typename Object, ResizePolicy Policy>
-	void* PoolAllocator<Object, Policy>::Allocate()
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	void* PoolAllocator<Object, Policy, Threading, Alignment, Logging>::Allocate(const AllocationTag tag)
 	{
+		void* freeChunk;
 
-		// No chunks left in the current block, or no block
-		// exists yet, Allocate a new one. If resize policy is fixed,
-		// then log an error.
-		if (m_CurrentPtr == nullptr)
+		if constexpr (Threading == ThreadingPolicy::MultiThreaded)
 		{
-			if constexpr (Policy == ResizePolicy::Fixed)
+			freeChunk = PopShared();
+			if (freeChunk == nullptr)
 			{
-				LOG_CORE_ERROR("{0} out of memory!", m_Data->DebugName);
+				return nullptr;
 			}
-			else
+
+			if constexpr (DefaultStatistics::ENABLED)
 			{
-				m_CurrentPtr = AllocateBlock(m_ObjectSize);
-				m_AllocatedBlocks.push_back(m_CurrentPtr);
+				// Threads may add at the same time
+				m_Data->UsedSize.fetch_add(m_ChunkSize, std::memory_order_relaxed);
+				m_Data->AddTaggedSize(tag, m_ObjectSize);
+				AllocationTracker::OnAllocate(m_Data.get(), freeChunk, m_ObjectSize);
 			}
+			Logging::OnAllocate(m_ObjectSize);
+
+			return freeChunk;
 		}
 
-		// The return value is the current position of
-		// the allocation pointer:
-		Chunk* freeChunk = m_CurrentPtr;
+		if (m_FreeList != nullptr)
+		{
+			// Reuse the most recently freed chunk, which is the most likely one to still be in the cache
+			freeChunk = m_FreeList;
+			m_FreeList = m_FreeList->next;
+		}
+		else
+		{
+			// No chunks left in the current block. If resize policy is fixed,
+			// then log an error, otherwise allocate a new block.
+			if (m_Cursor == m_BlockEnd)
+			{
+				if constexpr (Policy == ResizePolicy::Fixed)
+				{
+					LOG_CORE_ERROR("{0} out of memory!", m_Data->DebugName);
+					return nullptr;
+				}
+				else
+				{
+					AllocateBlock(m_ChunkSize);
+				}
+			}
 
-		// Advance (bump) the allocation pointer to the next chunk.
-		// When no chunks left, the `m_CurrentPtr` will be set to `nullptr`, and
-		// this will cause allocation of a new block on the next request:
-		m_CurrentPtr = m_CurrentPtr->next;
+			// Advance (bump) the cursor to the next chunk, which has never been touched
+			freeChunk = m_Cursor;
+			m_Cursor += m_ChunkSize;
+		}
 
-		m_Data->UsedSize += m_ObjectSize;
-		LOG_CORE_INFO("{0} Allocated {1} bytes", m_Data->DebugName, m_ObjectSize);
+		// ReleaseEmptyBlocks needs the used chunks of every block, so they are counted in any build
+		m_Data->PoolBlocks[FindBlock(freeChunk)].UsedChunks++;
+		if constexpr (DefaultStatistics::ENABLED)
+		{
+			m_Data->UsedSize.fetch_add(m_ChunkSize, std::memory_order_relaxed);
+			m_Data->AddTaggedSize(tag, m_ObjectSize);
+			AllocationTracker::OnAllocate(m_Data.get(), freeChunk, m_ObjectSize);
+		}
+		Logging::OnAllocate(m_ObjectSize);
 
 		return freeChunk;
 	}
-	template <typename Object, ResizePolicy Policy>
-	void PoolAllocator<Object, Policy>::Deallocate(Object* ptr)
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	void PoolAllocator<Object, Policy, Threading, Alignment, Logging>::Deallocate(Object* ptr, const AllocationTag tag)
 	{
+		if constexpr (DefaultStatistics::ENABLED)
+		{
+			AllocationTracker::OnDeallocate(ptr);
+			m_Data->RemoveTaggedSize(tag, m_ObjectSize);
+		}
+		Logging::OnDeallocate(m_ObjectSize);
+
+		if constexpr (Threading == ThreadingPolicy::MultiThreaded)
+		{
+			PushShared(reinterpret_cast<Chunk*>(ptr), reinterpret_cast<Chunk*>(ptr));
+
+			if constexpr (DefaultStatistics::ENABLED)
+			{
+				m_Data->UsedSize.fetch_sub(m_ChunkSize, std::memory_order_relaxed);
+			}
+			return;
+		}
+
 		// The freed chunk's next pointer points to the
-		// current allocation pointer:
-		reinterpret_cast<Chunk*>(ptr)->next = m_CurrentPtr;
+		// previous head of the free list:
+		reinterpret_cast<Chunk*>(ptr)->next = m_FreeList;
 
-		// And the allocation pointer is now set
-		// to the returned (free) chunk:
+		// And the free list now starts
+		// at the returned (free) chunk:
 
-		m_CurrentPtr = reinterpret_cast<Chunk*>(ptr);
+		m_FreeList = reinterpret_cast<Chunk*>(ptr);
 
-		m_Data->UsedSize -= m_ObjectSize;
-		LOG_CORE_INFO("{0} Deallocated {1} bytes", m_Data->DebugName, m_ObjectSize);
+		m_Data->PoolBlocks[FindBlock(ptr)].UsedChunks--;
+		if constexpr (DefaultStatistics::ENABLED)
+		{
+			m_Data->UsedSize.fetch_sub(m_ChunkSize, std::memory_order_relaxed);
+		}
 	}
 
-	template <typename Object, ResizePolicy Policy>
-	void PoolAllocator<Object, Policy>::Delete(Object* ptr)
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	void PoolAllocator<Object, Policy, Threading, Alignment, Logging>::Delete(Object* ptr)
 	{
 		ptr->~Object();	 // Call the destructor on the object
 		Deallocate(ptr); // Deallocate the pointer
 	}
 
-	template <typename Object, ResizePolicy Policy>
-	Chunk* PoolAllocator<Object, Policy>::AllocateBlock(Size chunkSize)
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	Size PoolAllocator<Object, Policy, Threading, Alignment, Logging>::AllocateN(Object** objects, const Size count)
+	{
+		Size allocatedCount = 0;
+
+		if constexpr (Threading == ThreadingPolicy::MultiThreaded)
+		{
+			while (allocatedCount < count)
+			{
+				Chunk* chunk = PopShared();
+				if (chunk == nullptr)
+				{
+					break;
+				}
+				objects[allocatedCount++] = reinterpret_cast<Object*>(chunk);
+			}
+
+			if constexpr (DefaultStatistics::ENABLED)
+			{
+				m_Data->UsedSize.fetch_add(allocatedCount * m_ChunkSize, std::memory_order_relaxed);
+			}
+		}
+		else
+		{
+			while (allocatedCount < count && m_FreeList != nullptr)
+			{
+				m_Data->PoolBlocks[FindBlock(m_FreeList)].UsedChunks++;
+				objects[allocatedCount++] = reinterpret_cast<Object*>(m_FreeList);
+				m_FreeList = m_FreeList->next;
+			}
+
+			while (allocatedCount < count)
+			{
+				if (m_Cursor == m_BlockEnd)
+				{
+					if constexpr (Policy == ResizePolicy::Fixed)
+					{
+						LOG_CORE_ERROR("{0} out of memory!", m_Data->DebugName);
+						break;
+					}
+					else
+					{
+						AllocateBlock(m_ChunkSize);
+					}
+				}
+
+				// Take as many fresh chunks from the current block as possible
+				const Size runCount = std::min<Size>(count - allocatedCount, (m_BlockEnd - m_Cursor) / m_ChunkSize);
+				m_Data->PoolBlocks[FindBlock(m_Cursor)].UsedChunks += runCount;
+				for (Size i = 0; i < runCount; i++)
+				{
+					objects[allocatedCount++] = reinterpret_cast<Object*>(m_Cursor);
+					m_Cursor += m_ChunkSize;
+				}
+			}
+
+			if constexpr (DefaultStatistics::ENABLED)
+			{
+				m_Data->UsedSize.fetch_add(allocatedCount * m_ChunkSize, std::memory_order_relaxed);
+			}
+		}
+
+		if constexpr (DefaultStatistics::ENABLED)
+		{
+			for (Size i = 0; i < allocatedCount; i++)
+			{
+				AllocationTracker::OnAllocate(m_Data.get(), objects[i], m_ObjectSize);
+			}
+		}
+		Logging::OnAllocate(allocatedCount * m_ObjectSize);
+
+		return allocatedCount;
+	}
+
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	void PoolAllocator<Object, Policy, Threading, Alignment, Logging>::DeallocateN(Object** objects, const Size count)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		if constexpr (DefaultStatistics::ENABLED)
+		{
+			for (Size i = 0; i < count; i++)
+			{
+				AllocationTracker::OnDeallocate(objects[i]);
+			}
+		}
+
+		// Chain the chunks in the order they were given, the first one ends up at the head of the free list
+		for (Size i = 0; i + 1 < count; i++)
+		{
+			reinterpret_cast<Chunk*>(objects[i])->next = reinterpret_cast<Chunk*>(objects[i + 1]);
+		}
+		Chunk* first = reinterpret_cast<Chunk*>(objects[0]);
+		Chunk* last = reinterpret_cast<Chunk*>(objects[count - 1]);
+
+		if constexpr (Threading == ThreadingPolicy::MultiThreaded)
+		{
+			PushShared(first, last);
+			if constexpr (DefaultStatistics::ENABLED)
+			{
+				m_Data->UsedSize.fetch_sub(count * m_ChunkSize, std::memory_order_relaxed);
+			}
+		}
+		else
+		{
+			last->next = m_FreeList;
+			m_FreeList = first;
+
+			for (Size i = 0; i < count; i++)
+			{
+				m_Data->PoolBlocks[FindBlock(objects[i])].UsedChunks--;
+			}
+			if constexpr (DefaultStatistics::ENABLED)
+			{
+				m_Data->UsedSize.fetch_sub(count * m_ChunkSize, std::memory_order_relaxed);
+			}
+		}
+
+		Logging::OnDeallocate(count * m_ObjectSize);
+	}
+
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	void PoolAllocator<Object, Policy, Threading, Alignment, Logging>::DeleteN(Object** objects, const Size count)
+	{
+		for (Size i = 0; i < count; i++)
+		{
+			objects[i]->~Object();
+		}
+		DeallocateN(objects, count);
+	}
+
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	void PoolAllocator<Object, Policy, Threading, Alignment, Logging>::AllocateBlock(Size chunkSize)
 	{
 		QMBT_CORE_ASSERT(chunkSize > sizeof(Chunk), "Object size must be larger than pointer size");
 
 		// The total memory (in Bytes), to be allocated
 		Size blockSize = m_BlockSize * chunkSize;
 
-		// The first chunk of the new block
-		Chunk* blockBegin = reinterpret_cast<Chunk*>(malloc(blockSize));
+		// The chunks are not linked up front, the cursor hands them out in order. Large blocks are mapped
+		// by the heap, so their pages are not backed until a chunk in them is used.
+		char* blockBegin = reinterpret_cast<char*>(::operator new(blockSize, std::align_val_t(m_ChunkAlignment)));
+		QMBT_CORE_ASSERT(((Size)blockBegin + blockSize) >> POINTER_BITS == 0, "Chunk addresses do not fit in a tagged pointer");
+
+		const auto position = std::upper_bound(m_Blocks.begin(), m_Blocks.end(), blockBegin);
+		if constexpr (Threading == ThreadingPolicy::SingleThreaded)
+		{
+			m_Data->PoolBlocks.insert(m_Data->PoolBlocks.begin() + (position - m_Blocks.begin()), {m_BlockSize, 0});
+		}
+		m_Blocks.insert(position, blockBegin);
+
+		m_Cursor = blockBegin;
+		m_BlockEnd = blockBegin + blockSize;
 
 		m_Data->TotalSize += blockSize;
+		m_Data->CommittedSize += blockSize;
 		MemoryManager::GetInstance().UpdateTotalSize(blockSize);
 
-		// Once the block is allocated, we need to chain all
-		// the chunks in this block:
+		m_BlockSize = std::min(m_BlockSize * 2, m_MaxBlockSize);
+	}
+
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	Size PoolAllocator<Object, Policy, Threading, Alignment, Logging>::FindBlock(const void* chunk) const
+	{
+		if constexpr (Policy == ResizePolicy::Fixed)
+		{
+			// The block from the constructor is the only one
+			return 0;
+		}
+		else
+		{
+			return std::upper_bound(m_Blocks.begin(), m_Blocks.end(), (const char*)chunk) - m_Blocks.begin() - 1;
+		}
+	}
+
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	Size PoolAllocator<Object, Policy, Threading, Alignment, Logging>::ReleaseEmptyBlocks()
+	{
+		static_assert(Policy == ResizePolicy::Resizable, "A fixed size pool cannot add a block again once it is released");
+		// Another thread may be reading a chunk of the block from the shared free list
+		static_assert(Threading == ThreadingPolicy::SingleThreaded, "Blocks of a multithreaded pool are only freed with it");
 
-		Chunk* chunk = blockBegin;
+		std::vector<AllocatorData::PoolBlock>& blocks = m_Data->PoolBlocks;
 
-		for (int i = 0; i < m_BlockSize - 1; ++i)
+		auto isEmpty = [&blocks](const Size block) { return blocks[block].UsedChunks == 0; };
+		if (std::none_of(blocks.begin(), blocks.end(), [](const AllocatorData::PoolBlock& block) { return block.UsedChunks == 0; }))
 		{
-			chunk->next =
-				reinterpret_cast<Chunk*>(reinterpret_cast<char*>(chunk) + chunkSize);
-			chunk = chunk->next;
+			return 0;
 		}
 
-		chunk->next = nullptr;
+		// Unlink the chunks of the empty blocks from the free list
+		Chunk** link = &m_FreeList;
+		while (*link != nullptr)
+		{
+			if (isEmpty(FindBlock(*link)))
+			{
+				*link = (*link)->next;
+			}
+			else
+			{
+				link = &(*link)->next;
+			}
+		}
+
+		Size releasedCount = 0;
+		for (Size block = 0; block < m_Blocks.size();)
+		{
+			if (!isEmpty(block))
+			{
+				block++;
+				continue;
+			}
+
+			const Size blockSize = blocks[block].ChunkCount * m_ChunkSize;
+			if (m_Cursor >= m_Blocks[block] && m_Cursor <= m_Blocks[block] + blockSize)
+			{
+				m_Cursor = nullptr;
+				m_BlockEnd = nullptr;
+			}
+
+			::operator delete(m_Blocks[block], std::align_val_t(m_ChunkAlignment));
+			m_Blocks.erase(m_Blocks.begin() + block);
+			blocks.erase(blocks.begin() + block);
+
+			m_Data->TotalSize -= blockSize;
+			m_Data->CommittedSize -= blockSize;
+			MemoryManager::GetInstance().UpdateTotalSize(-(Int64)blockSize);
+			releasedCount++;
+		}
+
+		LOG_CORE_INFO("{0} Released {1} empty blocks", m_Data->DebugName, releasedCount);
+
+		return releasedCount;
+	}
 
-		LOG_CORE_INFO("{0} Allocated block ({1} chunks)", m_Data->DebugName, m_BlockSize);
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	Chunk* PoolAllocator<Object, Policy, Threading, Alignment, Logging>::PopShared()
+	{
+		while (true)
+		{
+			UInt64 head = m_SharedFreeList.load(std::memory_order_acquire);
+			while ((head & POINTER_MASK) != 0)
+			{
+				// The chunk may be popped and reused by another thread meanwhile, in which case the value read
+				// here is garbage. The head has changed then, so the exchange fails and it is never used.
+				Chunk* chunk = (Chunk*)(head & POINTER_MASK);
+				Chunk* next = Utility::LoadRelaxed(&chunk->next);
+				if (m_SharedFreeList.compare_exchange_weak(head, PackHead(next, head), std::memory_order_acquire))
+				{
+					return chunk;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			// Another thread may have refilled the list while this one was waiting
+			if ((m_SharedFreeList.load(std::memory_order_relaxed) & POINTER_MASK) != 0)
+			{
+				continue;
+			}
+
+			if (m_Cursor == m_BlockEnd)
+			{
+				if constexpr (Policy == ResizePolicy::Fixed)
+				{
+					LOG_CORE_ERROR("{0} out of memory!", m_Data->DebugName);
+					return nullptr;
+				}
+				else
+				{
+					AllocateBlock(m_ChunkSize);
+				}
+			}
+
+			// Keep the first fresh chunk, and share the rest of the batch with the other threads
+			const Size count = std::max<Size>(std::min<Size>(SHARED_REFILL_SIZE / m_ChunkSize, (m_BlockEnd - m_Cursor) / m_ChunkSize), 1);
+			Chunk* first = reinterpret_cast<Chunk*>(m_Cursor);
+			m_Cursor += count * m_ChunkSize;
+
+			if (count > 1)
+			{
+				Chunk* second = reinterpret_cast<Chunk*>(reinterpret_cast<char*>(first) + m_ChunkSize);
+				Chunk* last = reinterpret_cast<Chunk*>(m_Cursor - m_ChunkSize);
+				for (Chunk* chunk = second; chunk != last; chunk = chunk->next)
+				{
+					chunk->next = reinterpret_cast<Chunk*>(reinterpret_cast<char*>(chunk) + m_ChunkSize);
+				}
+				PushShared(second, last);
+			}
 
-		return blockBegin;
+			return first;
+		}
+	}
+
+	template <typename Object, ResizePolicy Policy, ThreadingPolicy Threading, Size Alignment, typename Logging>
+	void PoolAllocator<Object, Policy, Threading, Alignment, Logging>::PushShared(Chunk* first, Chunk* last)
+	{
+		UInt64 head = m_SharedFreeList.load(std::memory_order_relaxed);
+		do
+		{
+			// A thread that is popping a stale head may read this at the same time
+			Utility::StoreRelaxed(&last->next, (Chunk*)(head & POINTER_MASK));
+		} while (!m_SharedFreeList.compare_exchange_weak(head, PackHead(first, head), std::memory_order_release, std::memory_order_relaxed));
 	}
 
 } // namespace QMBT
\ No newline at end of file
@@ -1,64 +1,82 @@
 #include "STLAllocator.hpp"
 
 #include "Core/Application.hpp"
-#include "Core/Logging/Logger.hpp"
+#include "MemoryResource.hpp"
+#include "SmallObjectAllocator.hpp"
 
 namespace QMBT
 {
-	extern FreeListAllocator g_GlobalAllocator;
-
-	STLAllocator::STLAllocator(const char* debugName)
+	STLAllocator::STLAllocator(const char* debugName, MemoryResource* resource)
 	{
 		m_DebugName = debugName;
+		m_Tag = AllocationTag(debugName);
+		m_Resource = resource;
 	}
 
 	STLAllocator::STLAllocator(const STLAllocator& other)
 	{
 		m_DebugName = other.m_DebugName;
+		m_Tag = other.m_Tag;
+		m_Resource = other.m_Resource;
 	}
 
 	STLAllocator::STLAllocator(const STLAllocator& other, const char* debugName)
 	{
 		m_DebugName = (debugName) ? debugName : other.m_DebugName;
+		m_Tag = (debugName) ? AllocationTag(debugName) : other.m_Tag;
+		m_Resource = other.m_Resource;
 	}
 
 	STLAllocator& STLAllocator::operator=(const STLAllocator& other)
 	{
 		m_DebugName = other.m_DebugName;
+		m_Tag = other.m_Tag;
+		m_Resource = other.m_Resource;
 		return *this;
 	}
 
+	// The global allocator is called directly, so the default containers never pay for a virtual call. Nothing
+	// here is logged, these are called for every allocation of every container, and before the loggers exist.
+
 	void* STLAllocator::allocate(size_t numBytes, int flags)
 	{
 		//void* ptr = ::new ((char*)0, flags, 0, (char*)0, 0) char[numBytes];
-		LOG_MEMORY_INFO("{0} Allocated {1} bytes", m_DebugName, numBytes);
-		return GetGlobalAllocator()->Allocate(numBytes, 8, m_DebugName);
+		return m_Resource ? m_Resource->Allocate(numBytes, 8, m_Tag) : GetSmallObjectAllocator()->Allocate(numBytes, 8, m_Tag);
 	}
 	void* STLAllocator::allocate(size_t numBytes, size_t alignment, size_t offset, int flags)
 	{
 		//void* ptr = ::new (alignment, offset, (char*)0, flags, 0, (char*)0, 0) char[numBytes];
-		LOG_MEMORY_INFO("{0} Allocated {1} bytes with alignment {2}", m_DebugName, numBytes, alignment);
-		return GetGlobalAllocator()->Allocate(numBytes, alignment, m_DebugName);
+		return m_Resource ? m_Resource->Allocate(numBytes, alignment, m_Tag) : GetSmallObjectAllocator()->Allocate(numBytes, alignment, m_Tag);
 	}
 	void STLAllocator::deallocate(void* ptr, size_t numBytes)
 	{
-		LOG_MEMORY_INFO("{0} Deallocated {1} bytes", m_DebugName, numBytes);
-		GetGlobalAllocator()->Deallocate(ptr, m_DebugName);
-	}
-
-	bool operator==(const STLAllocator& a, const STLAllocator& b)
-	{
-		if (&a == &b)
+		if (m_Resource)
 		{
-			return true; // allocator a and b are equal if they are the same
+			m_Resource->Deallocate(ptr, numBytes, m_Tag);
 		}
 		else
 		{
-			return false; // otherwise, return false, because the state m_totalAmountOfBytesAllocated needs to be increased/decreased on splice and swap
+			GetSmallObjectAllocator()->Deallocate(ptr, numBytes, m_Tag);
 		}
 	}
+	bool STLAllocator::try_expand(void* ptr, size_t numBytes, size_t newNumBytes)
+	{
+		return m_Resource ? m_Resource->TryExpand(ptr, numBytes, newNumBytes, m_Tag)
+						  : GetSmallObjectAllocator()->TryExpand(ptr, numBytes, newNumBytes, m_Tag);
+	}
+	void* STLAllocator::reallocate(void* ptr, size_t numBytes, size_t newNumBytes)
+	{
+		return m_Resource ? m_Resource->Reallocate(ptr, numBytes, newNumBytes, 8, m_Tag)
+						  : GetSmallObjectAllocator()->Reallocate(ptr, numBytes, newNumBytes, 8, m_Tag);
+	}
+
+	bool operator==(const STLAllocator& a, const STLAllocator& b)
+	{
+		// Blocks from one can be freed by the other when both use the same resource, and are counted under the same tag
+		return a.GetResource() == b.GetResource() && a.GetTag().GetID() == b.GetTag().GetID();
+	}
 	bool operator!=(const STLAllocator& a, const STLAllocator& b)
 	{
-		return false;
+		return !(a == b);
 	}
-} // namespace QMBT
\ No newline at end of file
+} // namespace QMBT
@@ -1,12 +1,27 @@
 #pragma once
 
+#include "AllocationTags.hpp"
+
 namespace QMBT
 {
+	class MemoryResource;
 
+	/**
+	 * @brief The allocator of every EASTL container in the engine.
+	 * @details Without a resource, blocks come from the global SmallObjectAllocator. With one, such as an
+	 * AllocatorResource around a FrameAllocator, every block of the container comes from it instead. Copies
+	 * share the resource, and two STLAllocators are equal when they use the same one under the same tag, so
+	 * containers on the same resource can swap their buffers without their tagged sizes drifting apart.
+	 *
+	 */
 	class STLAllocator
 	{
 	  public:
-		STLAllocator(const char* debugName = "STL Allocator");
+		/**
+		 * @param debugName The name the allocations are tagged with
+		 * @param resource Must outlive every container that uses it. nullptr for the global allocator.
+		 */
+		STLAllocator(const char* debugName = "STL Allocator", MemoryResource* resource = nullptr);
 		STLAllocator(const STLAllocator& other);
 		STLAllocator(const STLAllocator& other, const char* debugName);
 
@@ -16,8 +31,21 @@ namespace QMBT
 		void* allocate(size_t numBytes, size_t alignment, size_t offset, int flags = 0);
 		void deallocate(void* ptr, size_t numBytes);
 
+		// Resizes an allocation without moving it, returns false if it was left untouched
+		bool try_expand(void* ptr, size_t numBytes, size_t newNumBytes);
+		// Resizes an allocation in place if possible, and moves its bytes to a new one otherwise
+		void* reallocate(void* ptr, size_t numBytes, size_t newNumBytes);
+
+		inline MemoryResource* GetResource() const { return m_Resource; }
+		inline AllocationTag GetTag() const { return m_Tag; }
+
 	  protected:
 		const char* m_DebugName;
+		AllocationTag m_Tag; // The debug name, interned once so allocations do not have to hash it
+		MemoryResource* m_Resource;
 	};
 
+	bool operator==(const STLAllocator& a, const STLAllocator& b);
+	bool operator!=(const STLAllocator& a, const STLAllocator& b);
+
 } // namespace QMBT
\ No newline at end of file
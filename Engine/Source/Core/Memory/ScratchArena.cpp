@@ -0,0 +1,28 @@
+#include "ScratchArena.hpp"
+
+namespace QMBT
+{
+	namespace
+	{
+		std::atomic<Size> s_ThreadArenaCount{0};
+
+		struct ThreadArena
+		{
+			// The allocator only keeps a pointer to its name
+			std::string Name;
+			StackAllocator Allocator;
+
+			ThreadArena()
+				: Name("Scratch Arena (Thread " + std::to_string(s_ThreadArenaCount.fetch_add(1, std::memory_order_relaxed)) + ")"),
+				  Allocator(Name.c_str(), ScratchArena::THREAD_ARENA_SIZE, BackingPolicy::Pages)
+			{
+			}
+		};
+	} // namespace
+
+	StackAllocator& ScratchArena::GetThreadAllocator()
+	{
+		thread_local ThreadArena t_Arena;
+		return t_Arena.Allocator;
+	}
+} // namespace QMBT
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Core/Memory/StackAllocator.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief Temporary memory for the calling thread, freed when the ScratchArena goes out of scope
+	 * @details Every thread lazily gets its own page-backed StackAllocator the first time it opens a scratch
+	 * arena, so no locking is needed on any allocation. A ScratchArena only takes a marker of that allocator
+	 * and frees to it on destruction, so arenas can be nested within a thread as long as the inner one ends
+	 * first. Destructors are never called, and the memory must not be handed to another thread that outlives
+	 * the scope.
+	 *
+	 * The allocator of each thread is registered with the MemoryManager as "Scratch Arena (Thread N)", and is
+	 * released when its thread exits.
+	 */
+	class ScratchArena
+	{
+	  public:
+		// Only the pages a thread uses are committed
+		static constexpr Size THREAD_ARENA_SIZE = 4_MB;
+
+		ScratchArena()
+			: m_Allocator(GetThreadAllocator()), m_Scope(m_Allocator)
+		{
+		}
+
+		ScratchArena(const ScratchArena&) = delete;
+		ScratchArena& operator=(const ScratchArena&) = delete;
+
+		inline void* Allocate(const Size size, const Size alignment = 8) { return m_Allocator.Allocate(size, alignment); }
+
+		template <typename Object, typename... Args>
+		Object* New(Args&&... argList)
+		{
+			void* address = Allocate(sizeof(Object), alignof(Object));
+			return new (address) Object(std::forward<Args>(argList)...);
+		}
+
+		// The allocator of the calling thread, created on the first call from that thread
+		static StackAllocator& GetThreadAllocator();
+
+	  private:
+		StackAllocator& m_Allocator;
+		StackAllocatorScope m_Scope;
+	};
+} // namespace QMBT
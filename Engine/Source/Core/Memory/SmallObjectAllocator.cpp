@@ -0,0 +1,128 @@
+#include "SmallObjectAllocator.hpp"
+
+#include "AllocationTracker.hpp"
+#include "Core/Core.hpp"
+#include "ThreadCachedAllocator.hpp"
+
+namespace QMBT
+{
+	const char* const SmallObjectAllocator::s_PoolNames[SIZE_CLASS_COUNT] = {
+		"Small Objects (16 B)", "Small Objects (32 B)", "Small Objects (48 B)", "Small Objects (64 B)",
+		"Small Objects (80 B)", "Small Objects (96 B)", "Small Objects (112 B)", "Small Objects (128 B)",
+		"Small Objects (144 B)", "Small Objects (160 B)", "Small Objects (176 B)", "Small Objects (192 B)",
+		"Small Objects (208 B)", "Small Objects (224 B)", "Small Objects (240 B)", "Small Objects (256 B)"};
+
+	SmallObjectAllocator::SmallObjectAllocator(ThreadCachedAllocator* heap)
+		: m_Heap(heap)
+	{
+		QMBT_CORE_ASSERT(heap != nullptr, "Small object allocator needs a heap!");
+	}
+
+	template <Size... Indices>
+	void* SmallObjectAllocator::AllocateSmall(const Size sizeClass, const AllocationTag tag, std::integer_sequence<Size, Indices...>)
+	{
+		// One entry per pool, so finding the pool is a single indirect call
+		static constexpr void* (*s_Allocate[])(Pools&, AllocationTag) = {
+			[](Pools& pools, AllocationTag tag) -> void* { return std::get<Indices>(pools).Allocate(tag); }...};
+
+		return s_Allocate[sizeClass](m_Pools, tag);
+	}
+
+	template <Size... Indices>
+	void SmallObjectAllocator::DeallocateSmall(void* ptr, const Size sizeClass, const AllocationTag tag,
+											   std::integer_sequence<Size, Indices...>)
+	{
+		static constexpr void (*s_Deallocate[])(Pools&, void*, AllocationTag) = {
+			[](Pools& pools, void* ptr, AllocationTag tag) {
+				using ChunkType = typename std::tuple_element_t<Indices, Pools>::ChunkType;
+				std::get<Indices>(pools).Deallocate(static_cast<ChunkType*>(ptr), tag);
+			}...};
+
+		s_Deallocate[sizeClass](m_Pools, ptr, tag);
+	}
+
+	void* SmallObjectAllocator::Allocate(const Size size, const Size alignment, const AllocationTag tag)
+	{
+		if (!IsSmall(size))
+		{
+			return m_Heap->Allocate(size, alignment, tag);
+		}
+
+		QMBT_CORE_ASSERT(alignment <= SMALL_ALIGNMENT || size % alignment == 0,
+						 "Small blocks with an alignment above 16 must be a multiple of it in size!");
+		return AllocateSmall(GetSizeClass(size), tag, SizeClassSequence());
+	}
+
+	void SmallObjectAllocator::Deallocate(void* ptr, const Size size, const AllocationTag tag)
+	{
+		if (!IsSmall(size))
+		{
+			m_Heap->Deallocate(ptr, size, tag);
+			return;
+		}
+
+		DeallocateSmall(ptr, GetSizeClass(size), tag, SizeClassSequence());
+	}
+
+	bool SmallObjectAllocator::TryExpand(void* ptr, const Size size, const Size newSize, const AllocationTag tag)
+	{
+		if (!IsSmall(size) && !IsSmall(newSize))
+		{
+			return m_Heap->TryExpand(ptr, size, newSize, tag);
+		}
+
+		// The chunk already spans its whole size class, which is also what its pool counts
+		const bool expanded = IsSmall(size) && IsSmall(newSize) && GetSizeClass(size) == GetSizeClass(newSize);
+		if (expanded)
+		{
+			AllocationTracker::OnResize(ptr, newSize);
+		}
+
+		return expanded;
+	}
+
+	void* SmallObjectAllocator::Reallocate(void* ptr, const Size size, const Size newSize, const Size alignment, const AllocationTag tag)
+	{
+		if (ptr == nullptr)
+		{
+			return Allocate(newSize, alignment, tag);
+		}
+
+		if (!IsSmall(size) && !IsSmall(newSize))
+		{
+			return m_Heap->Reallocate(ptr, size, newSize, alignment, tag);
+		}
+
+		if (TryExpand(ptr, size, newSize, tag))
+		{
+			return ptr;
+		}
+
+		void* newPtr = Allocate(newSize, alignment, tag);
+		if (newPtr == nullptr)
+		{
+			return nullptr;
+		}
+
+		memcpy(newPtr, ptr, std::min(size, newSize));
+		Deallocate(ptr, size, tag);
+
+		return newPtr;
+	}
+
+	Size SmallObjectAllocator::GetUsedSize() const
+	{
+		return std::apply([](const auto&... pools) { return (pools.GetUsedSize() + ...); }, m_Pools);
+	}
+
+	const AllocatorData& SmallObjectAllocator::GetPoolAllocatorData(const Size sizeClass) const
+	{
+		QMBT_CORE_ASSERT(sizeClass < SIZE_CLASS_COUNT, "Size class out of range!");
+
+		return std::apply([sizeClass](const auto&... pools) -> const AllocatorData& {
+			const AllocatorData* data[] = {&pools.GetAllocatorData()...};
+			return *data[sizeClass];
+		},
+						  m_Pools);
+	}
+} // namespace QMBT
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "AllocatorData.hpp"
+#include "Core/Aliases.hpp"
+#include "Core/Core.hpp"
+#include "Core/Logging/Logger.hpp"
+#include "PoolAllocator.hpp"
+
+namespace QMBT
+{
+	class ThreadCachedAllocator;
+
+	/**
+	 * @brief Serves small allocations from pools of fixed size chunks, one pool per size class, and passes the
+	 * larger ones on to a heap.
+	 *
+	 * @details A chunk carries no header and its pool is picked from the size alone, so small blocks such as
+	 * string buffers, hash map nodes and shared pointer control blocks pay neither the header nor the search of
+	 * the heap. The pools are MultiThreaded, so any thread may free a chunk that another thread allocated.
+	 *
+	 * Deallocations take the size of the block, which is how the pool it came from is found. Every pool is
+	 * aligned to the largest power of 2 that divides its chunk size. A small block whose size is a multiple of
+	 * its alignment, as the size of every C++ type is, therefore always fits its own size class. Small blocks
+	 * with any other alignment above SMALL_ALIGNMENT are not supported.
+	 *
+	 */
+	class SmallObjectAllocator
+	{
+	  public:
+		static constexpr Size SIZE_CLASS_GRANULARITY = 16;
+		static constexpr Size SIZE_CLASS_COUNT = 16;
+		static constexpr Size MAX_SMALL_SIZE = SIZE_CLASS_GRANULARITY * SIZE_CLASS_COUNT;
+		static constexpr Size SMALL_ALIGNMENT = SIZE_CLASS_GRANULARITY; // Every size class is aligned to this at least
+
+	  private:
+		// The pools start with blocks of this many bytes and double them up to the maximum
+		static constexpr Size FIRST_BLOCK_SIZE = 4_KB;
+		static constexpr Size MAX_BLOCK_SIZE = 64_KB;
+
+		template <Size ChunkSize>
+		struct alignas(ChunkSize & (0 - ChunkSize)) SizeClassChunk
+		{
+			char bytes[ChunkSize];
+		};
+
+		// Every small container allocation goes through these, from any thread, so they are never logged
+		template <Size Index>
+		using SizeClassPoolBase = PoolAllocator<SizeClassChunk<(Index + 1) * SIZE_CLASS_GRANULARITY>, ResizePolicy::Resizable,
+												ThreadingPolicy::MultiThreaded, alignof(SizeClassChunk<(Index + 1) * SIZE_CLASS_GRANULARITY>), NoLogging>;
+
+		template <Size Index>
+		class SizeClassPool : public SizeClassPoolBase<Index>
+		{
+		  public:
+			static constexpr Size CHUNK_SIZE = (Index + 1) * SIZE_CLASS_GRANULARITY;
+			using ChunkType = SizeClassChunk<CHUNK_SIZE>;
+
+			SizeClassPool()
+				: SizeClassPoolBase<Index>(s_PoolNames[Index], FIRST_BLOCK_SIZE / CHUNK_SIZE, MAX_BLOCK_SIZE / CHUNK_SIZE)
+			{
+			}
+		};
+
+		template <typename Sequence>
+		struct PoolSet;
+
+		template <Size... Indices>
+		struct PoolSet<std::integer_sequence<Size, Indices...>>
+		{
+			using Type = std::tuple<SizeClassPool<Indices>...>;
+		};
+
+		using SizeClassSequence = std::make_integer_sequence<Size, SIZE_CLASS_COUNT>;
+		using Pools = typename PoolSet<SizeClassSequence>::Type;
+
+	  public:
+		/**
+		 * @brief Construct a new Small Object Allocator object. The pools register themselves with the
+		 * MemoryManager, one per size class.
+		 *
+		 * @param heap Where allocations larger than MAX_SMALL_SIZE go. Has to outlive this allocator.
+		 */
+		explicit SmallObjectAllocator(ThreadCachedAllocator* heap);
+
+		SmallObjectAllocator(const SmallObjectAllocator&) = delete;
+		SmallObjectAllocator& operator=(const SmallObjectAllocator&) = delete;
+
+		void* Allocate(const Size size, const Size alignment = 8, const AllocationTag tag = AllocationTag());
+
+		// The size must be the one the block was allocated with
+		void Deallocate(void* ptr, const Size size, const AllocationTag tag = AllocationTag());
+
+		/**
+		 * @brief Resizes an allocation without moving it. Small blocks can only be resized within their size
+		 * class, and never turn into large ones or the other way around.
+		 *
+		 * @param size The size the block was allocated with
+		 * @return bool False if the allocation was left untouched
+		 */
+		bool TryExpand(void* ptr, const Size size, const Size newSize, const AllocationTag tag = AllocationTag());
+
+		// Resizes an allocation in place if possible, and moves it to a new block otherwise
+		void* Reallocate(void* ptr, const Size size, const Size newSize, const Size alignment = 8, const AllocationTag tag = AllocationTag());
+
+		static inline bool IsSmall(const Size size) { return size <= MAX_SMALL_SIZE; }
+		static inline Size GetSizeClass(const Size size) { return (std::max(size, Size(1)) - 1) / SIZE_CLASS_GRANULARITY; }
+
+		// Of the chunks handed out by the pools. Large blocks are counted by the heap.
+		Size GetUsedSize() const;
+		const AllocatorData& GetPoolAllocatorData(const Size sizeClass) const;
+		inline ThreadCachedAllocator* GetHeap() const { return m_Heap; }
+
+	  private:
+		template <Size... Indices>
+		void* AllocateSmall(const Size sizeClass, const AllocationTag tag, std::integer_sequence<Size, Indices...>);
+		template <Size... Indices>
+		void DeallocateSmall(void* ptr, const Size sizeClass, const AllocationTag tag, std::integer_sequence<Size, Indices...>);
+
+	  private:
+		static const char* const s_PoolNames[SIZE_CLASS_COUNT];
+
+		ThreadCachedAllocator* m_Heap;
+		Pools m_Pools;
+	};
+} // namespace QMBT
@@ -4,23 +4,36 @@
 
 namespace QMBT
 {
-	StackAllocator::StackAllocator(const char* debugName, Size totalSize)
-		: m_Data(std::make_shared<AllocatorData>(debugName, totalSize)), m_HeadPtr(malloc(m_Data->TotalSize))
+	StackAllocator::StackAllocator(const char* debugName, Size totalSize, const BackingPolicy backingPolicy)
+		: m_Data(std::make_shared<AllocatorData>(debugName, totalSize)), m_BackingPolicy(backingPolicy),
+		  m_DecommitGranularity(PageAllocator::GetDecommitGranularity(backingPolicy)),
+		  m_HeadPtr(PageAllocator::Map(m_Data->TotalSize, backingPolicy))
 	{
 		QMBT_CORE_ASSERT(totalSize < 1_GB && totalSize > 0, "Total size of allocator cannot be more than 1 GB or less than 0");
 
 		// Allows the memory manager to keep track of total allocated memory
 		MemoryManager::GetInstance().Register(m_Data);
+		DefaultLogging::Initialize(debugName);
 
 		m_Offset = 0;
+		m_TopOffset = m_Data->TotalSize;
+		m_TopCommittedOffset = m_Data->TotalSize;
+		m_PeakTopOffset = m_Data->TotalSize;
+
+		// Freshly mapped pages are not backed by anything until they are touched
+		if (m_DecommitGranularity != 0)
+		{
+			m_Data->CommittedSize = 0;
+		}
 
 		LOG_MEMORY_INFO("Initialized {0} of size {1}", m_Data->DebugName, Utility::ToReadable(m_Data->TotalSize));
 	}
 
 	StackAllocator::~StackAllocator()
 	{
+		AllocationTracker::OnRelease(m_Data.get());
 		MemoryManager::GetInstance().UnRegister(m_Data);
-		free(m_HeadPtr);
+		PageAllocator::Unmap(m_HeadPtr, m_Data->TotalSize, m_BackingPolicy);
 	}
 
 	void* StackAllocator::Allocate(const Size size, const Size alignment)
@@ -29,7 +42,7 @@ namespace QMBT
 
 		Size padding = Utility::CalculatePaddingWithHeader(currentAddress, alignment, sizeof(AllocationHeader));
 
-		if (m_Offset + padding + size > m_Data->TotalSize)
+		if (m_Offset + padding + size > m_TopOffset)
 		{
 			LOG_MEMORY_CRITICAL("{0}: Allocation exceeded maximum size of {1}!",
 								m_Data->DebugName,
@@ -40,10 +53,68 @@ namespace QMBT
 
 		const Size nextAddress = currentAddress + padding;
 
+		// Lets Deallocate find the start of the padding
+		reinterpret_cast<AllocationHeader*>(nextAddress - sizeof(AllocationHeader))->padding = static_cast<unsigned char>(padding);
+
 		m_Offset += size;
+		m_PeakOffset = std::max(m_PeakOffset, m_Offset);
+
+		if (m_DecommitGranularity != 0 && m_Offset > m_CommittedOffset)
+		{
+			m_CommittedOffset = Utility::AlignForward(m_Offset, m_DecommitGranularity);
+			UpdateCommittedSize();
+		}
+
+		UpdateUsedSize();
+
+		if constexpr (DefaultStatistics::ENABLED)
+		{
+			if (AllocationTracker::OnAllocate(m_Data.get(), reinterpret_cast<void*>(nextAddress), size))
+			{
+				m_SampledAllocations.push_back(nextAddress);
+			}
+		}
+
+		DefaultLogging::OnAllocate(size);
+		return reinterpret_cast<void*>(nextAddress);
+	}
+
+	void* StackAllocator::AllocateTop(const Size size, const Size alignment)
+	{
+		const Size topAddress = (Size)m_HeadPtr + m_TopOffset;
+
+		// The block ends where the top end currently starts, and its start is aligned down
+		if (size > topAddress - ((Size)m_HeadPtr + m_Offset) ||
+			Utility::AlignBackward(topAddress - size, alignment) < (Size)m_HeadPtr + m_Offset)
+		{
+			LOG_MEMORY_CRITICAL("{0}: Top allocation exceeded maximum size of {1}!",
+								m_Data->DebugName,
+								Utility::ToReadable(m_Data->TotalSize));
+			return nullptr;
+		}
+
+		const Size nextAddress = Utility::AlignBackward(topAddress - size, alignment);
+
+		m_TopOffset = nextAddress - (Size)m_HeadPtr;
+		m_PeakTopOffset = std::min(m_PeakTopOffset, m_TopOffset);
+
+		if (m_DecommitGranularity != 0 && m_TopOffset < m_TopCommittedOffset)
+		{
+			m_TopCommittedOffset = Utility::AlignBackward(m_TopOffset, m_DecommitGranularity);
+			UpdateCommittedSize();
+		}
 
-		m_Data->UsedSize = m_Offset;
-		LOG_MEMORY_INFO("{0} Allocated {1} bytes with alignment {2}", m_Data->DebugName, size, alignment);
+		UpdateUsedSize();
+
+		if constexpr (DefaultStatistics::ENABLED)
+		{
+			if (AllocationTracker::OnAllocate(m_Data.get(), reinterpret_cast<void*>(nextAddress), size))
+			{
+				m_SampledTopAllocations.push_back(nextAddress);
+			}
+		}
+
+		DefaultLogging::OnAllocate(size);
 		return reinterpret_cast<void*>(nextAddress);
 	}
 
@@ -55,10 +126,108 @@ namespace QMBT
 		const Size headerAddress = ptr - sizeof(AllocationHeader);
 		const AllocationHeader* allocationHeader{reinterpret_cast<AllocationHeader*>(headerAddress)};
 
-		m_Offset = ptr - allocationHeader->padding - (Size)m_HeadPtr;
-		m_Data->UsedSize = m_Offset;
+		const Size offset = ptr - allocationHeader->padding - (Size)m_HeadPtr;
+		RollBack(offset, offset);
 
-		LOG_MEMORY_INFO("{0} Deallocated {1} bytes", m_Data->DebugName, Utility::ToReadable(initialOffset - m_Offset));
+		DefaultLogging::OnDeallocate(initialOffset - m_Offset);
+	}
+
+	void StackAllocator::FreeToMarker(const Marker marker)
+	{
+		QMBT_CORE_ASSERT(marker <= m_Offset, "Marker is above the top of the stack, it was already freed!");
+
+		const Size initialOffset = m_Offset;
+		RollBack(marker, marker);
+
+		DefaultLogging::OnDeallocate(initialOffset - m_Offset);
+	}
+
+	void StackAllocator::FreeToTopMarker(const Marker marker)
+	{
+		QMBT_CORE_ASSERT(marker >= m_TopOffset && marker <= m_Data->TotalSize, "Top marker is below the top end of the stack, it was already freed!");
+
+		const Size initialOffset = m_TopOffset;
+		RollBackTop(marker, marker);
+
+		DefaultLogging::OnDeallocate(m_TopOffset - initialOffset);
+	}
+
+	void StackAllocator::Reset()
+	{
+		RollBack(0, m_PeakOffset);
+		RollBackTop(m_Data->TotalSize, m_PeakTopOffset);
+
+		m_PeakOffset = 0;
+		m_PeakTopOffset = m_Data->TotalSize;
+
+		m_Data->LastPeakUsedSize = m_Data->PeakUsedSize;
+		m_Data->PeakUsedSize = 0;
+	}
+
+	void StackAllocator::RollBack(const Size offset, const Size keptOffset)
+	{
+		// Everything above the new top is freed, sampled or not
+		while (!m_SampledAllocations.empty() && m_SampledAllocations.back() >= (Size)m_HeadPtr + offset)
+		{
+			AllocationTracker::OnDeallocate(reinterpret_cast<void*>(m_SampledAllocations.back()));
+			m_SampledAllocations.pop_back();
+		}
+
+		m_Offset = offset;
+		UpdateUsedSize();
+
+		// Keep some pages above the top committed, so a stack that keeps growing and shrinking
+		// by a little does not make a system call every time. The pages of the top end are left alone.
+		if (m_DecommitGranularity != 0)
+		{
+			const Size keptCommittedOffset = Utility::AlignForward(keptOffset + DECOMMIT_THRESHOLD, m_DecommitGranularity);
+			const Size committedOffset = std::min(m_CommittedOffset, m_TopCommittedOffset);
+			if (committedOffset >= keptCommittedOffset + DECOMMIT_THRESHOLD)
+			{
+				PageAllocator::Decommit(reinterpret_cast<void*>((Size)m_HeadPtr + keptCommittedOffset), committedOffset - keptCommittedOffset, m_BackingPolicy);
+				m_CommittedOffset = keptCommittedOffset;
+				UpdateCommittedSize();
+			}
+		}
+	}
+
+	void StackAllocator::RollBackTop(const Size offset, const Size keptOffset)
+	{
+		while (!m_SampledTopAllocations.empty() && m_SampledTopAllocations.back() < (Size)m_HeadPtr + offset)
+		{
+			AllocationTracker::OnDeallocate(reinterpret_cast<void*>(m_SampledTopAllocations.back()));
+			m_SampledTopAllocations.pop_back();
+		}
+
+		m_TopOffset = offset;
+		UpdateUsedSize();
+
+		// The same as the bottom end, mirrored
+		if (m_DecommitGranularity != 0 && keptOffset > DECOMMIT_THRESHOLD)
+		{
+			const Size keptCommittedOffset = Utility::AlignBackward(keptOffset - DECOMMIT_THRESHOLD, m_DecommitGranularity);
+			const Size committedOffset = std::max(m_TopCommittedOffset, m_CommittedOffset);
+			if (keptCommittedOffset >= committedOffset + DECOMMIT_THRESHOLD)
+			{
+				PageAllocator::Decommit(reinterpret_cast<void*>((Size)m_HeadPtr + committedOffset), keptCommittedOffset - committedOffset, m_BackingPolicy);
+				m_TopCommittedOffset = keptCommittedOffset;
+				UpdateCommittedSize();
+			}
+		}
+	}
+
+	void StackAllocator::UpdateUsedSize()
+	{
+		const Size usedSize = m_Offset + m_Data->TotalSize - m_TopOffset;
+		m_Data->UsedSize.store(usedSize, std::memory_order_relaxed);
+		m_Data->PeakUsedSize = std::max(m_Data->PeakUsedSize, usedSize);
+	}
+
+	void StackAllocator::UpdateCommittedSize()
+	{
+		// The two committed spans overlap once the ends have met
+		const Size topCommittedSize = m_Data->TotalSize - std::min(m_TopCommittedOffset, m_Data->TotalSize);
+		m_Data->CommittedSize = std::min(std::min(m_CommittedOffset, m_TopCommittedOffset) + topCommittedSize, m_Data->TotalSize);
 	}
 
 } // namespace QMBT
@@ -1,10 +1,19 @@
 #pragma once
 
+#include "Core/Memory/AllocationTracker.hpp"
+#include "Core/Memory/AllocatorPolicies.hpp"
 #include "Core/Memory/MemoryManager.hpp"
+#include "Core/Memory/PageAllocator.hpp"
 #include "Core/Memory/Utility/MemoryUtils.hpp"
 
 namespace QMBT
 {
+	// The two ends of a stack allocator, which grow towards each other
+	enum class StackEnd : UInt8
+	{
+		Bottom, // For long-lived data, freed by Deallocate or a bottom marker
+		Top		// For temporaries, only freed by a top marker
+	};
 
 	/**
 	 * @brief A custom memory allocator which allocates in a stack-like manner
@@ -14,10 +23,20 @@ namespace QMBT
 	 * also need to be done in a stack-like manner. It is the task of the user to 
 	 * make sure that deallocations happen in an order that is the reverse of the allocation
 	 * order.
+	 *
+	 * The stack is double-ended. Allocate grows it from the bottom and AllocateTop from the top of the same
+	 * buffer, so long-lived data and temporaries can share one budget, and an allocation only fails once the
+	 * two ends meet. Each end has its own markers, and freeing one end never touches the other.
+	 *
+	 * The allocations are only tracked and logged with the DefaultStatistics and DefaultLogging policies. The
+	 * used and peak sizes follow from the two ends, so they are kept in every build.
 	 */
-	class StackAllocator
+	class StackAllocator : private DefaultLogging
 	{
 	  public:
+		// The top of the stack at some point, everything allocated after it can be freed at once with FreeToMarker
+		using Marker = Size;
+
 		//Prohibit default construction, moving and assignment
 		StackAllocator() = delete;
 		StackAllocator(const StackAllocator&) = delete;
@@ -30,9 +49,11 @@ namespace QMBT
 		 * 
 		 * @param debugName The name that will appear in logs and any editor.
 		 * @param totalSize This will be allocated up-front. Even if the stack allocator is empty, it will
-		 * consume this amount of memory.
+		 * consume this amount of memory, unless the backing policy maps pages.
+		 * @param backingPolicy With any policy other than BackingPolicy::Heap, pages are only committed once the
+		 * stack grows into them, and are given back to the OS when it shrinks well below them.
 		 */
-		StackAllocator(const char* debugName = "Allocator", const Size totalSize = 50_MB);
+		StackAllocator(const char* debugName = "Allocator", const Size totalSize = 50_MB, const BackingPolicy backingPolicy = BackingPolicy::Heap);
 
 		~StackAllocator();
 
@@ -46,6 +67,13 @@ namespace QMBT
 		 */
 		void* Allocate(const Size size, const Size alignment = 8);
 
+		/**
+		 * @brief Allocates raw memory from the top end without calling any constructor
+		 * @details Allocation complexity is O(1). There is no header, so the memory can only be freed with
+		 * FreeToTopMarker or Reset.
+		 */
+		void* AllocateTop(const Size size, const Size alignment = 8);
+
 		/**
 		 * @brief Allocates a new block of memory and calls the constructor
 		 * @details Allocation complexity is O(1)
@@ -58,6 +86,13 @@ namespace QMBT
 		template <typename Object, typename... Args>
 		Object* New(Args... argList);
 
+		template <typename Object, typename... Args>
+		Object* NewTop(Args&&... argList)
+		{
+			void* address = AllocateTop(sizeof(Object), alignof(Object));
+			return new (address) Object(std::forward<Args>(argList)...);
+		}
+
 		/**
 		 * @brief Deallocates raw memory without calling any destructor
 		 * @details Deallocation complexity is O(1)
@@ -76,15 +111,75 @@ namespace QMBT
 		template <typename Object>
 		void Delete(Object* ptr);
 
+		inline Marker GetMarker() const { return m_Offset; }
+		inline Marker GetTopMarker() const { return m_TopOffset; }
+
+		/**
+		 * @brief Deallocates everything that was allocated after the marker was taken, without calling any destructor
+		 * @details Deallocation complexity is O(1)
+		 *
+		 * @param marker A marker taken from this allocator, not below any marker that was freed to since
+		 */
+		void FreeToMarker(const Marker marker);
+
+		// Deallocates everything that was allocated from the top end after the top marker was taken
+		void FreeToTopMarker(const Marker marker);
+
+		/**
+		 * @brief Deallocates everything at both ends and starts a new high-water mark
+		 * @details The previous high-water mark is kept in AllocatorData::LastPeakUsedSize, and as many pages
+		 * as it needed stay committed, so a stack that is filled to the same height after every reset does not
+		 * fault its pages back in.
+		 */
+		void Reset();
+
 		inline Size GetUsedSize() const { return m_Data->UsedSize; }
+		inline Size GetCommittedSize() const { return m_Data->CommittedSize; }
+		inline const AllocatorData& GetAllocatorData() const { return *m_Data; }
+
+		// Whether ptr points into memory that is currently allocated
+		inline bool Contains(const void* ptr) const
+		{
+			const Size offset = (Size)ptr - (Size)m_HeadPtr;
+			return (Size)ptr >= (Size)m_HeadPtr && (offset < m_Offset || (offset >= m_TopOffset && offset < m_Data->TotalSize));
+		}
+		inline void* GetHeadPtr() const { return m_HeadPtr; }
 
 	  private:
 		StackAllocator(StackAllocator& stackAllocator); //Restrict copying
 
+		// Moves the bottom end down to offset, and gives back the pages well above keptOffset
+		void RollBack(const Size offset, const Size keptOffset);
+		// Moves the top end up to offset, and gives back the pages well below keptOffset
+		void RollBackTop(const Size offset, const Size keptOffset);
+
+		void UpdateUsedSize();
+		void UpdateCommittedSize();
+
+		// Pages are given back once at least this many bytes past the top of the stack are committed, and as
+		// many bytes above the top stay committed
+		static constexpr Size DECOMMIT_THRESHOLD = 1_MB;
+
 		std::shared_ptr<AllocatorData> m_Data;
+		BackingPolicy m_BackingPolicy;
+		Size m_DecommitGranularity;
 
 		void* m_HeadPtr{nullptr}; // Points to the first available location
 		Size m_Offset{0};
+		Size m_CommittedOffset{0}; // The pages below this offset may be committed
+
+		// The top end starts at this offset and reaches the end of the buffer
+		Size m_TopOffset{0};
+		Size m_TopCommittedOffset{0}; // The pages from this offset on may be committed
+
+		// How far each end has grown since the last reset
+		Size m_PeakOffset{0};
+		Size m_PeakTopOffset{0};
+
+		// Addresses of the allocations the tracker has sampled, in ascending order. A deallocation frees
+		// everything above it, so all the samples at or above its address are removed with it.
+		std::vector<Size> m_SampledAllocations;
+		std::vector<Size> m_SampledTopAllocations; // In descending order
 
 		struct AllocationHeader
 		{
@@ -92,6 +187,40 @@ namespace QMBT
 		};
 	};
 
+	/**
+	 * @brief Frees everything allocated from a stack allocator during its lifetime when it goes out of scope
+	 * @details Scopes can be nested, as long as the inner one ends first.
+	 */
+	class StackAllocatorScope
+	{
+	  public:
+		explicit StackAllocatorScope(StackAllocator& allocator, const StackEnd end = StackEnd::Bottom)
+			: m_Allocator(allocator), m_End(end),
+			  m_Marker(end == StackEnd::Bottom ? allocator.GetMarker() : allocator.GetTopMarker())
+		{
+		}
+
+		~StackAllocatorScope()
+		{
+			if (m_End == StackEnd::Bottom)
+			{
+				m_Allocator.FreeToMarker(m_Marker);
+			}
+			else
+			{
+				m_Allocator.FreeToTopMarker(m_Marker);
+			}
+		}
+
+		StackAllocatorScope(const StackAllocatorScope&) = delete;
+		StackAllocatorScope& operator=(const StackAllocatorScope&) = delete;
+
+	  private:
+		StackAllocator& m_Allocator;
+		const StackEnd m_End;
+		const StackAllocator::Marker m_Marker;
+	};
+
 	template <typename Object, typename... Args>
 	Object* StackAllocator::New(Args... argList)
 	{
@@ -0,0 +1,275 @@
+#include "ThreadCachedAllocator.hpp"
+
+#include "AllocationTracker.hpp"
+#include "Core/Core.hpp"
+
+namespace QMBT
+{
+	std::mutex ThreadCachedAllocator::s_RegistryMutex;
+	thread_local ThreadCachedAllocator::ThreadCacheSet ThreadCachedAllocator::s_ThreadCaches;
+	thread_local bool ThreadCachedAllocator::s_ThreadExiting = false;
+
+	ThreadCachedAllocator::ThreadCachedAllocator(const char* debugName, const Size totalSize, const FreeListAllocator::PlacementPolicy policy,
+												 const ResizePolicy resizePolicy, const BackingPolicy backingPolicy)
+		: m_Heap(debugName, totalSize, policy, resizePolicy, backingPolicy)
+	{
+		// Blocks are tracked once they are handed out by this allocator, not when the caches take them
+		m_Heap.m_Tracked = false;
+	}
+
+	ThreadCachedAllocator::~ThreadCachedAllocator()
+	{
+		// The cached blocks live in the heap, so they are gone with it. Detaching the caches
+		// lets their threads reuse them for another allocator.
+		std::lock_guard<std::mutex> lock(s_RegistryMutex);
+		for (ThreadCache* cache : m_Caches)
+		{
+			cache->owner.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	void* ThreadCachedAllocator::Allocate(const Size size, const Size alignment, const AllocationTag tag)
+	{
+		QMBT_CORE_ASSERT(alignment >= 8, "Alignment must be 8 at least");
+
+		void* ptr;
+		if (size <= MAX_CACHED_SIZE)
+		{
+			// Small blocks always get the whole size class and the cache alignment, even when they do not come
+			// from a cache, so any thread can cache them once they are freed
+			const Size sizeClass = GetSizeClass(size);
+
+			ThreadCache* cache;
+			if (alignment <= CACHE_ALIGNMENT && (cache = GetThreadCache()) != nullptr)
+			{
+				if (cache->bins[sizeClass] == nullptr)
+				{
+					Refill(cache, sizeClass);
+					if (cache->bins[sizeClass] == nullptr)
+					{
+						return nullptr;
+					}
+				}
+
+				Chunk* chunk = cache->bins[sizeClass];
+				cache->bins[sizeClass] = chunk->next;
+				cache->counts[sizeClass]--;
+				ptr = chunk;
+			}
+			else
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				ptr = m_Heap.Allocate((sizeClass + 1) * CACHE_CLASS_GRANULARITY, std::max(alignment, CACHE_ALIGNMENT));
+			}
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			ptr = m_Heap.Allocate(size, alignment);
+		}
+
+		if (ptr != nullptr)
+		{
+			m_Heap.m_Data->AddTaggedSize(tag, size);
+			AllocationTracker::OnAllocate(m_Heap.m_Data.get(), ptr, size);
+		}
+
+		return ptr;
+	}
+
+	void ThreadCachedAllocator::Deallocate(void* ptr, const Size size, const AllocationTag tag)
+	{
+		AllocationTracker::OnDeallocate(ptr);
+		m_Heap.m_Data->RemoveTaggedSize(tag, size);
+
+		ThreadCache* cache;
+		if (size <= MAX_CACHED_SIZE && (cache = GetThreadCache()) != nullptr)
+		{
+			const Size sizeClass = GetSizeClass(size);
+
+			Chunk* chunk = (Chunk*)ptr;
+			chunk->next = cache->bins[sizeClass];
+			cache->bins[sizeClass] = chunk;
+
+			const Size batchSize = GetBatchSize(sizeClass);
+			if (++cache->counts[sizeClass] > 2 * batchSize)
+			{
+				Flush(cache, sizeClass, batchSize);
+			}
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Heap.Deallocate(ptr);
+		}
+	}
+
+	bool ThreadCachedAllocator::TryExpand(void* ptr, const Size size, const Size newSize, const AllocationTag tag)
+	{
+		bool expanded;
+		if (size <= MAX_CACHED_SIZE || newSize <= MAX_CACHED_SIZE)
+		{
+			// The block already spans its whole size class
+			expanded = size <= MAX_CACHED_SIZE && newSize <= MAX_CACHED_SIZE && GetSizeClass(size) == GetSizeClass(newSize);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			expanded = m_Heap.TryExpand(ptr, newSize);
+		}
+
+		if (expanded)
+		{
+			m_Heap.m_Data->AddTaggedSize(tag, newSize - size);
+			AllocationTracker::OnResize(ptr, newSize);
+		}
+
+		return expanded;
+	}
+
+	void* ThreadCachedAllocator::Reallocate(void* ptr, const Size size, const Size newSize, const Size alignment, const AllocationTag tag)
+	{
+		if (ptr == nullptr)
+		{
+			return Allocate(newSize, alignment, tag);
+		}
+
+		if (TryExpand(ptr, size, newSize, tag))
+		{
+			return ptr;
+		}
+
+		void* newPtr = Allocate(newSize, alignment, tag);
+		if (newPtr == nullptr)
+		{
+			return nullptr;
+		}
+
+		memcpy(newPtr, ptr, std::min(size, newSize));
+		Deallocate(ptr, size, tag);
+
+		return newPtr;
+	}
+
+	void ThreadCachedAllocator::FlushThreadCache()
+	{
+		ThreadCache* cache = GetThreadCache();
+		if (cache == nullptr)
+		{
+			return;
+		}
+
+		for (Size sizeClass = 0; sizeClass < CACHE_CLASS_COUNT; sizeClass++)
+		{
+			Flush(cache, sizeClass, cache->counts[sizeClass]);
+		}
+	}
+
+	void ThreadCachedAllocator::ReleaseIdleRegions()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Heap.ReleaseIdleRegions();
+	}
+
+	ThreadCachedAllocator::ThreadCache* ThreadCachedAllocator::GetThreadCache()
+	{
+		// Blocks freed by the destructors of other thread locals go straight to the heap
+		if (s_ThreadExiting)
+		{
+			return nullptr;
+		}
+
+		ThreadCache* unusedCache = nullptr;
+		for (ThreadCache& cache : s_ThreadCaches.caches)
+		{
+			ThreadCachedAllocator* owner = cache.owner.load(std::memory_order_relaxed);
+			if (owner == this)
+			{
+				return &cache;
+			}
+			if (owner == nullptr && unusedCache == nullptr)
+			{
+				unusedCache = &cache;
+			}
+		}
+
+		if (unusedCache == nullptr)
+		{
+			return nullptr;
+		}
+
+		// The cache may still hold blocks of an allocator that has been destroyed
+		std::fill(std::begin(unusedCache->bins), std::end(unusedCache->bins), nullptr);
+		std::fill(std::begin(unusedCache->counts), std::end(unusedCache->counts), 0);
+
+		std::lock_guard<std::mutex> lock(s_RegistryMutex);
+		m_Caches.push_back(unusedCache);
+		unusedCache->owner.store(this, std::memory_order_relaxed);
+
+		return unusedCache;
+	}
+
+	void ThreadCachedAllocator::Refill(ThreadCache* cache, const Size sizeClass)
+	{
+		const Size classSize = (sizeClass + 1) * CACHE_CLASS_GRANULARITY;
+		const Size batchSize = GetBatchSize(sizeClass);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (Size i = 0; i < batchSize; i++)
+		{
+			Chunk* chunk = (Chunk*)m_Heap.Allocate(classSize, CACHE_ALIGNMENT);
+			if (chunk == nullptr)
+			{
+				break;
+			}
+
+			chunk->next = cache->bins[sizeClass];
+			cache->bins[sizeClass] = chunk;
+			cache->counts[sizeClass]++;
+		}
+	}
+
+	void ThreadCachedAllocator::Flush(ThreadCache* cache, const Size sizeClass, Size count)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		cache->counts[sizeClass] -= count;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		while (count-- > 0)
+		{
+			Chunk* chunk = cache->bins[sizeClass];
+			cache->bins[sizeClass] = chunk->next;
+			m_Heap.Deallocate(chunk);
+		}
+	}
+
+	void ThreadCachedAllocator::ReleaseThreadCache(ThreadCache* cache)
+	{
+		for (Size sizeClass = 0; sizeClass < CACHE_CLASS_COUNT; sizeClass++)
+		{
+			Flush(cache, sizeClass, cache->counts[sizeClass]);
+		}
+
+		m_Caches.erase(std::find(m_Caches.begin(), m_Caches.end(), cache));
+		cache->owner.store(nullptr, std::memory_order_relaxed);
+	}
+
+	ThreadCachedAllocator::ThreadCacheSet::~ThreadCacheSet()
+	{
+		s_ThreadExiting = true;
+
+		std::lock_guard<std::mutex> lock(s_RegistryMutex);
+		for (ThreadCache& cache : caches)
+		{
+			ThreadCachedAllocator* owner = cache.owner.load(std::memory_order_relaxed);
+			if (owner != nullptr)
+			{
+				owner->ReleaseThreadCache(&cache);
+			}
+		}
+	}
+} // namespace QMBT
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "AllocatorData.hpp"
+#include "Core/Aliases.hpp"
+#include "FreeListAllocator.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief A thread safe allocator that puts a cache per thread in front of a shared FreeListAllocator.
+	 *
+	 * @details Every thread keeps the blocks it frees in bins by size class, and serves small allocations
+	 * from those bins without taking a lock. Only an empty or overfull bin goes to the shared heap, and it
+	 * moves a whole batch of blocks under a single lock. Allocations that are too large or too aligned for
+	 * the bins always go to the shared heap.
+	 *
+	 * Deallocations take the size of the block, so a thread never has to read the boundary tags of the heap,
+	 * which the heap may be changing under its lock at the same time.
+	 *
+	 */
+	class ThreadCachedAllocator
+	{
+	  private:
+		static constexpr Size CACHE_CLASS_GRANULARITY = 16;
+		static constexpr Size CACHE_CLASS_COUNT = 64;
+		static constexpr Size MAX_CACHED_SIZE = CACHE_CLASS_GRANULARITY * CACHE_CLASS_COUNT;
+		static constexpr Size CACHE_ALIGNMENT = 16; // Every cached block is aligned to this
+		static constexpr Size CACHE_BATCH_BYTES = 4_KB;
+		static constexpr Size MIN_CACHE_BATCH = 4;
+		static constexpr Size MAX_CACHE_BATCH = 64;
+		static constexpr Size MAX_THREAD_CACHES = 8; // Per thread, further allocators fall back to the lock
+
+		struct ThreadCache
+		{
+			std::atomic<ThreadCachedAllocator*> owner{nullptr};
+			Chunk* bins[CACHE_CLASS_COUNT] = {};
+			UInt32 counts[CACHE_CLASS_COUNT] = {};
+		};
+
+		// Destroyed when its thread exits, giving every cached block back to its allocator
+		struct ThreadCacheSet
+		{
+			ThreadCache caches[MAX_THREAD_CACHES];
+
+			~ThreadCacheSet();
+		};
+
+	  public:
+		ThreadCachedAllocator(const char* debugName = "ThreadCachedAllocator", const Size totalSize = 50_MB,
+							  const FreeListAllocator::PlacementPolicy policy = FreeListAllocator::FIND_SEGREGATED,
+							  const ResizePolicy resizePolicy = ResizePolicy::Fixed, const BackingPolicy backingPolicy = BackingPolicy::Heap);
+
+		~ThreadCachedAllocator();
+
+		void* Allocate(const Size size, const Size alignment = 8, const AllocationTag tag = AllocationTag());
+
+		template <typename Object, typename... Args>
+		Object* New(Args... argList);
+
+		// The size must be the one the block was allocated with
+		void Deallocate(void* ptr, const Size size, const AllocationTag tag = AllocationTag());
+
+		template <typename Object>
+		void Delete(Object* ptr);
+
+		/**
+		 * @brief Resizes an allocation without moving it, see FreeListAllocator::TryExpand. Small blocks can only
+		 * be resized within their size class, and never turn into large ones or the other way around.
+		 *
+		 * @param size The size the block was allocated with
+		 * @return bool False if the allocation was left untouched
+		 */
+		bool TryExpand(void* ptr, const Size size, const Size newSize, const AllocationTag tag = AllocationTag());
+
+		// Resizes an allocation in place if possible, and moves it to a new block otherwise
+		void* Reallocate(void* ptr, const Size size, const Size newSize, const Size alignment = 8, const AllocationTag tag = AllocationTag());
+
+		// Gives every block cached by the calling thread back to the shared heap
+		void FlushThreadCache();
+
+		// See FreeListAllocator::ReleaseIdleRegions. Blocks held in thread caches keep their regions in use.
+		void ReleaseIdleRegions();
+
+		// Includes the blocks held in thread caches
+		inline Size GetUsedSize() const { return m_Heap.GetUsedSize(); }
+		inline Size GetTotalSize() const { return m_Heap.GetTotalSize(); }
+		inline const AllocatorData& GetAllocatorData() const { return m_Heap.GetAllocatorData(); }
+
+	  private:
+		ThreadCachedAllocator(ThreadCachedAllocator& threadCachedAllocator);
+
+		static inline Size GetSizeClass(const Size size) { return (std::max(size, Size(1)) - 1) / CACHE_CLASS_GRANULARITY; }
+		static inline Size GetBatchSize(const Size sizeClass)
+		{
+			return std::clamp(CACHE_BATCH_BYTES / ((sizeClass + 1) * CACHE_CLASS_GRANULARITY), MIN_CACHE_BATCH, MAX_CACHE_BATCH);
+		}
+
+		ThreadCache* GetThreadCache();
+		void Refill(ThreadCache* cache, const Size sizeClass);
+		void Flush(ThreadCache* cache, const Size sizeClass, Size count);
+		void ReleaseThreadCache(ThreadCache* cache);
+
+	  private:
+		FreeListAllocator m_Heap;
+		std::mutex m_Mutex; // Guards m_Heap
+
+		std::vector<ThreadCache*> m_Caches; // Guarded by s_RegistryMutex
+
+		static std::mutex s_RegistryMutex;
+		static thread_local ThreadCacheSet s_ThreadCaches;
+		static thread_local bool s_ThreadExiting;
+	};
+
+	template <typename Object, typename... Args>
+	Object* ThreadCachedAllocator::New(Args... argList)
+	{
+		void* address = Allocate(sizeof(Object)); // Allocate the raw memory and get a pointer to it
+		// Nothing is constructed when the allocator is out of memory
+		return address == nullptr ? nullptr : new (address) Object(argList...);
+	}
+
+	template <typename Object>
+	void ThreadCachedAllocator::Delete(Object* ptr)
+	{
+		ptr->~Object();					 // Call the destructor on the object
+		Deallocate(ptr, sizeof(Object)); // Deallocate the pointer
+	}
+} // namespace QMBT
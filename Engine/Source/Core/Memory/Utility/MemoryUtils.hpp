@@ -2,6 +2,10 @@
 
 #include "Core/Aliases.hpp"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace QMBT
 {
 	namespace Utility
@@ -37,5 +41,67 @@ namespace QMBT
 
 			return padding;
 		}
+
+		inline const Size AlignForward(const Size value, const Size alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		inline const Size AlignBackward(const Size value, const Size alignment)
+		{
+			return value & ~(alignment - 1);
+		}
+
+		// The next multiple of a size that does not have to be a power of 2, unlike an alignment
+		inline const Size RoundUp(const Size value, const Size multiple)
+		{
+			return (value + multiple - 1) / multiple * multiple;
+		}
+
+		// Index of the lowest set bit. The value must not be 0.
+		inline UInt32 FindFirstSet(const UInt64 value)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward64(&index, value);
+			return index;
+#else
+			return __builtin_ctzll(value);
+#endif
+		}
+
+		// Index of the highest set bit. The value must not be 0.
+		inline UInt32 FindLastSet(const UInt64 value)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return index;
+#else
+			return 63 - __builtin_clzll(value);
+#endif
+		}
+
+		// Relaxed atomic access to a pointer that other threads may write at the same time, such as the link of
+		// a chunk in a lock-free list. Aligned pointers are read and written whole by every supported compiler.
+		template <typename T>
+		inline T* LoadRelaxed(T* const* address)
+		{
+#ifdef _MSC_VER
+			return *static_cast<T* const volatile*>(address);
+#else
+			return __atomic_load_n(address, __ATOMIC_RELAXED);
+#endif
+		}
+
+		template <typename T>
+		inline void StoreRelaxed(T** address, T* value)
+		{
+#ifdef _MSC_VER
+			*static_cast<T* volatile*>(address) = value;
+#else
+			__atomic_store_n(address, value, __ATOMIC_RELAXED);
+#endif
+		}
 	} // namespace Utility
 } // namespace QMBT
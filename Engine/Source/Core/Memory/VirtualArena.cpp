@@ -0,0 +1,121 @@
+#include "VirtualArena.hpp"
+#include "Core/Core.hpp"
+#include "Utility/Size.hpp"
+
+namespace QMBT
+{
+	VirtualArena::VirtualArena(const char* debugName, const Size reservedSize, const Size commitSize)
+		: m_Data(std::make_shared<AllocatorData>(debugName, 0)),
+		  m_CommitSize(Utility::AlignForward(commitSize, PageAllocator::GetDecommitGranularity(BackingPolicy::Pages)))
+	{
+		QMBT_CORE_ASSERT(reservedSize > 0, "Reserved size of arena cannot be 0");
+		QMBT_CORE_ASSERT(commitSize > 0, "Commit size of arena cannot be 0");
+
+		// Whole pages, but not necessarily a power of 2
+		m_Data->ReservedSize = Utility::RoundUp(reservedSize, m_CommitSize);
+		m_BasePtr = PageAllocator::Reserve(m_Data->ReservedSize);
+		QMBT_CORE_ASSERT(m_BasePtr, "Could not reserve the address space of the arena!");
+
+		// Nothing counts against the budget before it is committed
+		MemoryManager::GetInstance().Register(m_Data);
+		DefaultLogging::Initialize(debugName);
+
+		LOG_MEMORY_INFO("Initialized {0} with {1} of address space", m_Data->DebugName, Utility::ToReadable(m_Data->ReservedSize));
+	}
+
+	VirtualArena::~VirtualArena()
+	{
+		AllocationTracker::OnRelease(m_Data.get());
+		SetCommittedOffset(0);
+		MemoryManager::GetInstance().UnRegister(m_Data);
+		PageAllocator::Unmap(m_BasePtr, m_Data->ReservedSize, BackingPolicy::Pages);
+	}
+
+	void* VirtualArena::Allocate(const Size size, const Size alignment)
+	{
+		const Size address = Utility::AlignForward((Size)m_BasePtr + m_Offset, alignment);
+		const Size offset = address - (Size)m_BasePtr;
+
+		if (offset + size > m_Data->ReservedSize)
+		{
+			LOG_MEMORY_CRITICAL("{0}: Allocation exceeded reserved size of {1}!",
+								m_Data->DebugName,
+								Utility::ToReadable(m_Data->ReservedSize));
+			return nullptr;
+		}
+
+		if (offset + size > m_CommittedOffset && !CommitTo(offset + size))
+		{
+			LOG_MEMORY_CRITICAL("{0}: Could not commit {1}, the system is out of memory!",
+								m_Data->DebugName,
+								Utility::ToReadable(offset + size));
+			return nullptr;
+		}
+
+		m_Offset = offset + size;
+		m_Data->UsedSize = m_Offset;
+		m_Data->PeakUsedSize = std::max(m_Data->PeakUsedSize, m_Offset);
+
+		if constexpr (DefaultStatistics::ENABLED)
+		{
+			if (AllocationTracker::OnAllocate(m_Data.get(), reinterpret_cast<void*>(address), size))
+			{
+				m_SampledAllocations.push_back(address);
+			}
+		}
+
+		DefaultLogging::OnAllocate(size);
+		return reinterpret_cast<void*>(address);
+	}
+
+	void VirtualArena::FreeToMarker(const Marker marker)
+	{
+		QMBT_CORE_ASSERT(marker <= m_Offset, "Marker is above the top of the arena, it was already freed!");
+
+		while (!m_SampledAllocations.empty() && m_SampledAllocations.back() >= (Size)m_BasePtr + marker)
+		{
+			AllocationTracker::OnDeallocate(reinterpret_cast<void*>(m_SampledAllocations.back()));
+			m_SampledAllocations.pop_back();
+		}
+
+		DefaultLogging::OnDeallocate(m_Offset - marker);
+
+		m_Offset = marker;
+		m_Data->UsedSize = m_Offset;
+	}
+
+	void VirtualArena::Reset()
+	{
+		FreeToMarker(0);
+		SetCommittedOffset(0);
+
+		m_Data->LastPeakUsedSize = m_Data->PeakUsedSize;
+		m_Data->PeakUsedSize = 0;
+	}
+
+	bool VirtualArena::CommitTo(const Size offset)
+	{
+		const Size committedOffset = std::min(Utility::RoundUp(offset, m_CommitSize), m_Data->ReservedSize);
+		if (!PageAllocator::Commit(reinterpret_cast<void*>((Size)m_BasePtr + m_CommittedOffset), committedOffset - m_CommittedOffset))
+		{
+			return false;
+		}
+
+		SetCommittedOffset(committedOffset);
+		return true;
+	}
+
+	void VirtualArena::SetCommittedOffset(const Size committedOffset)
+	{
+		if (committedOffset < m_CommittedOffset)
+		{
+			PageAllocator::Uncommit(reinterpret_cast<void*>((Size)m_BasePtr + committedOffset), m_CommittedOffset - committedOffset);
+		}
+
+		// The committed memory is what counts against the budget
+		MemoryManager::GetInstance().UpdateTotalSize((Int64)committedOffset - (Int64)m_CommittedOffset);
+		m_CommittedOffset = committedOffset;
+		m_Data->TotalSize = m_CommittedOffset;
+		m_Data->CommittedSize = m_CommittedOffset;
+	}
+} // namespace QMBT
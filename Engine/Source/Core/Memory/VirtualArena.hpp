@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Core/Memory/AllocationTracker.hpp"
+#include "Core/Memory/AllocatorPolicies.hpp"
+#include "Core/Memory/MemoryManager.hpp"
+#include "Core/Memory/PageAllocator.hpp"
+#include "Core/Memory/Utility/MemoryUtils.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief A linear allocator that reserves a huge region of address space and commits it as it grows
+	 * @details Nothing is reserved from the heap. The whole region is reserved up front without being backed
+	 * by anything, and is committed a block at a time as the top of the arena moves past it. The region never
+	 * moves, so pointers stay valid and growing never copies anything. Reset gives every committed page back
+	 * to the OS and makes it inaccessible again, so memory that is used after the reset faults instead of
+	 * silently reading zeroes.
+	 *
+	 * Only the committed memory counts against the application budget. It is kept in AllocatorData::TotalSize,
+	 * and the reservation in AllocatorData::ReservedSize.
+	 *
+	 * Like StackAllocator, the allocations are only tracked and logged with the DefaultStatistics and
+	 * DefaultLogging policies, and the used and peak sizes follow from the top of the arena in every build.
+	 */
+	class VirtualArena : private DefaultLogging
+	{
+	  public:
+		// The top of the arena at some point, everything allocated after it can be freed at once with FreeToMarker
+		using Marker = Size;
+
+		// The arena commits at least this much at a time, so growing by small allocations does not make a system call each time
+		static constexpr Size DEFAULT_COMMIT_SIZE = 64_KB;
+
+		//Prohibit default construction, copying and moving
+		VirtualArena() = delete;
+		VirtualArena(const VirtualArena&) = delete;
+		VirtualArena& operator=(const VirtualArena&) = delete;
+
+		/**
+		 * @brief Construct a new Virtual Arena object.
+		 *
+		 * @param debugName The name that will appear in logs and any editor.
+		 * @param reservedSize The most the arena can ever hold. Only address space is taken, so tens of GB are fine.
+		 * @param commitSize How much is committed at a time, rounded up to whole pages. Does not have to be a power of 2.
+		 */
+		VirtualArena(const char* debugName = "Virtual Arena", const Size reservedSize = 64_GB, const Size commitSize = DEFAULT_COMMIT_SIZE);
+
+		~VirtualArena();
+
+		/**
+		 * @brief Allocates raw memory without calling any constructor
+		 * @details Allocation complexity is O(1), plus a system call when a new block has to be committed
+		 *
+		 * @return void* nullptr if the reservation is full or the OS is out of memory
+		 */
+		void* Allocate(const Size size, const Size alignment = 8);
+
+		template <typename Object, typename... Args>
+		Object* New(Args&&... argList)
+		{
+			void* address = Allocate(sizeof(Object), alignof(Object));
+			return address == nullptr ? nullptr : new (address) Object(std::forward<Args>(argList)...);
+		}
+
+		inline Marker GetMarker() const { return m_Offset; }
+
+		/**
+		 * @brief Deallocates everything that was allocated after the marker was taken, without calling any destructor
+		 * @details The pages stay committed for the next allocations, only Reset gives them back.
+		 */
+		void FreeToMarker(const Marker marker);
+
+		// Deallocates everything and gives all the committed pages back to the OS
+		void Reset();
+
+		inline Size GetUsedSize() const { return m_Data->UsedSize; }
+		inline Size GetCommittedSize() const { return m_Data->CommittedSize; }
+		inline Size GetReservedSize() const { return m_Data->ReservedSize; }
+		inline const AllocatorData& GetAllocatorData() const { return *m_Data; }
+
+	  private:
+		// Commits the blocks below offset that are not committed yet
+		bool CommitTo(const Size offset);
+		void SetCommittedOffset(const Size committedOffset);
+
+		std::shared_ptr<AllocatorData> m_Data;
+		Size m_CommitSize;
+
+		void* m_BasePtr{nullptr};
+		Size m_Offset{0};
+		Size m_CommittedOffset{0}; // Everything below this offset is committed
+
+		// Addresses of the allocations the tracker has sampled, in ascending order
+		std::vector<Size> m_SampledAllocations;
+	};
+} // namespace QMBT
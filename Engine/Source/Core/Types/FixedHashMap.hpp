@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "Core/Memory/STLAllocator.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief A hash map that keeps its nodes and buckets for the first N entries inside itself.
+	 * @details Past N entries, nodes overflow to an STLAllocator. The bucket count is fixed at N + 1, so a map
+	 * that keeps growing far past N gets slower rather than rehashing.
+	 *
+	 */
+	template <typename Key, typename T, size_t N, bool EnableOverflow = true, typename Hash = eastl::hash<Key>>
+	using FixedHashMap = eastl::fixed_hash_map<Key, T, N, N + 1, EnableOverflow, Hash, eastl::equal_to<Key>, false, STLAllocator>;
+} // namespace QMBT
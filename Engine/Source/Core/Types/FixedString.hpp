@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "Core/Memory/STLAllocator.hpp"
+
+namespace QMBT
+{
+	// A string that keeps up to N - 1 characters inside itself, and overflows to an STLAllocator past that
+	template <size_t N, bool EnableOverflow = true>
+	using FixedString = eastl::fixed_string<char, N, EnableOverflow, STLAllocator>;
+} // namespace QMBT
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "Core/Memory/STLAllocator.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief A vector that keeps its first N elements inside itself, so small ones never allocate.
+	 * @details Past N elements it overflows to an STLAllocator, which can be pointed at any MemoryResource
+	 * with set_overflow_allocator. Without overflow, pushing past N elements is an error.
+	 *
+	 */
+	template <typename T, size_t N, bool EnableOverflow = true>
+	using FixedVector = eastl::fixed_vector<T, N, EnableOverflow, STLAllocator>;
+} // namespace QMBT
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "Core/Aliases.hpp"
+#include "Core/Core.hpp"
+#include "Core/Types/Vector.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief Refers to an object in a SlotMap. Stays the same size as an index, but unlike a pointer or an
+	 * index it can tell whether the object it was handed out for has been removed.
+	 * @details The low bits hold the slot index and the high bits the generation of the slot. The generation
+	 * goes up every time the object in the slot is removed, which makes every older handle stale.
+	 *
+	 */
+	class SlotHandle
+	{
+	  public:
+		static constexpr UInt32 INDEX_BITS = 20;
+		static constexpr UInt32 MAX_INDEX = (1u << INDEX_BITS) - 1;
+		static constexpr UInt32 MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;
+
+		constexpr SlotHandle() = default;
+		constexpr SlotHandle(const UInt32 index, const UInt32 generation)
+			: m_Value(index | (generation << INDEX_BITS))
+		{
+		}
+
+		inline constexpr UInt32 GetIndex() const { return m_Value & MAX_INDEX; }
+		inline constexpr UInt32 GetGeneration() const { return m_Value >> INDEX_BITS; }
+
+		// A default constructed handle never refers to an object
+		inline constexpr bool IsValid() const { return m_Value != INVALID; }
+
+		inline constexpr bool operator==(const SlotHandle other) const { return m_Value == other.m_Value; }
+		inline constexpr bool operator!=(const SlotHandle other) const { return m_Value != other.m_Value; }
+
+	  private:
+		static constexpr UInt32 INVALID = ~UInt32(0);
+
+		UInt32 m_Value = INVALID;
+	};
+
+	/**
+	 * @brief A container that hands out handles to its objects and keeps the objects themselves packed in one
+	 * array, so iterating over them touches contiguous memory instead of chasing pointers.
+	 * @details Insert, Remove and Get are all O(1). A removed object is replaced by the last one, so the
+	 * order of the objects changes and pointers to them do not stay valid, but handles do. Slots are reused,
+	 * newest freed first. A slot whose generation has run out is retired instead, so a stale handle can never
+	 * match a newer object.
+	 *
+	 * All the arrays come from the allocator, which is given the debug name of the map.
+	 *
+	 * @tparam T The type of the objects
+	 */
+	template <typename T, typename Allocator = STLAllocator>
+	class SlotMap
+	{
+	  public:
+		using Iterator = T*;
+		using ConstIterator = const T*;
+
+		SlotMap(const char* debugName = "SlotMap")
+			: m_Objects(Allocator(debugName)), m_ObjectSlots(Allocator(debugName)), m_Slots(Allocator(debugName))
+		{
+		}
+
+		template <typename... Args>
+		SlotHandle Emplace(Args&&... args);
+
+		inline SlotHandle Insert(const T& object) { return Emplace(object); }
+		inline SlotHandle Insert(T&& object) { return Emplace(std::move(object)); }
+
+		/**
+		 * @brief Destroys the object of a handle. The last object is moved into its place.
+		 *
+		 * @return bool False if the handle is stale, in which case nothing is removed
+		 */
+		bool Remove(const SlotHandle handle);
+
+		// Returns nullptr if the handle is stale. The pointer is valid until the next insertion or removal.
+		inline T* Get(const SlotHandle handle)
+		{
+			return Contains(handle) ? &m_Objects[m_Slots[handle.GetIndex()].objectIndex] : nullptr;
+		}
+		inline const T* Get(const SlotHandle handle) const
+		{
+			return Contains(handle) ? &m_Objects[m_Slots[handle.GetIndex()].objectIndex] : nullptr;
+		}
+
+		inline bool Contains(const SlotHandle handle) const
+		{
+			return handle.GetIndex() < m_Slots.size() && m_Slots[handle.GetIndex()].generation == handle.GetGeneration();
+		}
+
+		// The handle of the object at a position in the packed array, for example while iterating
+		inline SlotHandle GetHandle(const Size objectIndex) const
+		{
+			const UInt32 slot = m_ObjectSlots[objectIndex];
+			return SlotHandle(slot, m_Slots[slot].generation);
+		}
+
+		void Reserve(const Size capacity);
+		// Removes every object. Every handle that has been handed out becomes stale.
+		void Clear();
+
+		inline Size GetSize() const { return m_Objects.size(); }
+		inline bool IsEmpty() const { return m_Objects.empty(); }
+
+		inline T* GetData() { return m_Objects.data(); }
+		inline T& operator[](const Size objectIndex) { return m_Objects[objectIndex]; }
+		inline const T& operator[](const Size objectIndex) const { return m_Objects[objectIndex]; }
+
+		inline Iterator begin() { return m_Objects.begin(); }
+		inline Iterator end() { return m_Objects.end(); }
+		inline ConstIterator begin() const { return m_Objects.begin(); }
+		inline ConstIterator end() const { return m_Objects.end(); }
+
+	  private:
+		static constexpr UInt32 NO_SLOT = ~UInt32(0);
+
+		struct Slot
+		{
+			union
+			{
+				UInt32 objectIndex; // While the slot is in use
+				UInt32 nextFree;	// While the slot is in the free list
+			};
+			UInt32 generation;
+		};
+
+		// Frees the slot of a removed object and makes the handles to it stale
+		void FreeSlot(const UInt32 slot);
+
+	  private:
+		Vector<T, Allocator> m_Objects;
+		Vector<UInt32, Allocator> m_ObjectSlots; // The slot of every object, in the same order
+		Vector<Slot, Allocator> m_Slots;
+
+		UInt32 m_FreeSlots = NO_SLOT; // Most recently freed first
+	};
+
+	template <typename T, typename Allocator>
+	template <typename... Args>
+	SlotHandle SlotMap<T, Allocator>::Emplace(Args&&... args)
+	{
+		UInt32 slot = m_FreeSlots;
+		if (slot != NO_SLOT)
+		{
+			m_FreeSlots = m_Slots[slot].nextFree;
+		}
+		else
+		{
+			// The last index is left out, so an invalid handle never refers to a slot
+			QMBT_CORE_ASSERT(m_Slots.size() < SlotHandle::MAX_INDEX, "Too many slots for a handle!");
+
+			slot = (UInt32)m_Slots.size();
+			m_Slots.push_back(Slot{});
+			m_Slots[slot].generation = 0;
+		}
+
+		m_Slots[slot].objectIndex = (UInt32)m_Objects.size();
+		m_Objects.emplace_back(std::forward<Args>(args)...);
+		m_ObjectSlots.push_back(slot);
+
+		return SlotHandle(slot, m_Slots[slot].generation);
+	}
+
+	template <typename T, typename Allocator>
+	bool SlotMap<T, Allocator>::Remove(const SlotHandle handle)
+	{
+		if (!Contains(handle))
+		{
+			return false;
+		}
+
+		const UInt32 slot = handle.GetIndex();
+		const UInt32 objectIndex = m_Slots[slot].objectIndex;
+		const UInt32 lastIndex = (UInt32)m_Objects.size() - 1;
+
+		// Fill the hole with the last object, so the objects stay packed
+		if (objectIndex != lastIndex)
+		{
+			m_Objects[objectIndex] = std::move(m_Objects[lastIndex]);
+			m_ObjectSlots[objectIndex] = m_ObjectSlots[lastIndex];
+			m_Slots[m_ObjectSlots[objectIndex]].objectIndex = objectIndex;
+		}
+		m_Objects.pop_back();
+		m_ObjectSlots.pop_back();
+
+		FreeSlot(slot);
+
+		return true;
+	}
+
+	template <typename T, typename Allocator>
+	void SlotMap<T, Allocator>::Reserve(const Size capacity)
+	{
+		m_Objects.reserve(capacity);
+		m_ObjectSlots.reserve(capacity);
+		m_Slots.reserve(capacity);
+	}
+
+	template <typename T, typename Allocator>
+	void SlotMap<T, Allocator>::Clear()
+	{
+		for (const UInt32 slot : m_ObjectSlots)
+		{
+			FreeSlot(slot);
+		}
+		m_Objects.clear();
+		m_ObjectSlots.clear();
+	}
+
+	template <typename T, typename Allocator>
+	void SlotMap<T, Allocator>::FreeSlot(const UInt32 slot)
+	{
+		if (m_Slots[slot].generation == SlotHandle::MAX_GENERATION)
+		{
+			// A generation that is not in use by any handle, so the slot is never found by Contains again
+			m_Slots[slot].generation = SlotHandle::MAX_GENERATION + 1;
+			return;
+		}
+
+		m_Slots[slot].generation++;
+		m_Slots[slot].nextFree = m_FreeSlots;
+		m_FreeSlots = slot;
+	}
+} // namespace QMBT
@@ -6,7 +6,119 @@
 
 namespace QMBT
 {
+	namespace Detail
+	{
+		template <typename Allocator, typename = void>
+		struct CanTryExpand : std::false_type
+		{
+		};
+
+		template <typename Allocator>
+		struct CanTryExpand<Allocator, std::void_t<decltype(std::declval<Allocator&>().try_expand(nullptr, size_t(0), size_t(0)))>> : std::true_type
+		{
+		};
+	} // namespace Detail
+
+	/**
+	 * @brief An eastl::vector that first tries to grow its buffer in place when it runs out of capacity.
+	 * @details Only the growth is changed, so the elements never move if the allocator can extend the buffer.
+	 * Allocators without a try_expand member grow the way eastl::vector does.
+	 *
+	 * eastl::vector has no virtual members, so reserve, resize, push_back and emplace_back are hidden rather
+	 * than overridden. They only try to grow in place when called on a Vector, not through a reference to the
+	 * eastl::vector, and every other member that grows the vector, such as insert, always moves the elements.
+	 * The growth reads and writes the buffer pointers of eastl::VectorBase directly, which TryExpand checks at
+	 * compile time so an EASTL update that changes them does not go unnoticed.
+	 */
 	template <typename T, typename Allocator = STLAllocator>
-	using Vector = eastl::vector<T, Allocator>;
+	class Vector : public eastl::vector<T, Allocator>
+	{
+	  private:
+		using Base = eastl::vector<T, Allocator>;
+
+	  public:
+		using typename Base::size_type;
+
+		using Base::Base;
+
+		void reserve(size_type n)
+		{
+			if (n > this->capacity())
+			{
+				TryExpand(n);
+			}
+			Base::reserve(n);
+		}
+
+		void resize(size_type n)
+		{
+			if (n > this->capacity())
+			{
+				TryExpand(std::max(n, this->GetNewCapacity(this->capacity())));
+			}
+			Base::resize(n);
+		}
+
+		void resize(size_type n, const T& value)
+		{
+			if (n > this->capacity())
+			{
+				TryExpand(std::max(n, this->GetNewCapacity(this->capacity())));
+			}
+			Base::resize(n, value);
+		}
+
+		// The value may live in the vector itself, which is fine since expanding never moves the elements
+		void push_back(const T& value)
+		{
+			if (this->mpEnd == this->internalCapacityPtr())
+			{
+				TryExpand(this->GetNewCapacity(this->capacity()));
+			}
+			Base::push_back(value);
+		}
+
+		void push_back(T&& value)
+		{
+			if (this->mpEnd == this->internalCapacityPtr())
+			{
+				TryExpand(this->GetNewCapacity(this->capacity()));
+			}
+			Base::push_back(std::move(value));
+		}
+
+		template <typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			if (this->mpEnd == this->internalCapacityPtr())
+			{
+				TryExpand(this->GetNewCapacity(this->capacity()));
+			}
+			return Base::emplace_back(std::forward<Args>(args)...);
+		}
+
+	  private:
+		// Leaves the vector untouched if the buffer cannot grow in place, the caller then grows it by copying
+		void TryExpand(const size_type newCapacity)
+		{
+			static_assert(std::is_same_v<decltype(this->mpBegin), T*> && std::is_same_v<decltype(this->mpEnd), T*>,
+						  "Vector relies on the buffer pointers of eastl::VectorBase");
+			static_assert(std::is_same_v<decltype(this->internalCapacityPtr()), T*&>,
+						  "Vector relies on eastl::VectorBase::internalCapacityPtr returning the capacity pointer by reference");
+			static_assert(std::is_same_v<decltype(this->internalAllocator()), Allocator&>,
+						  "Vector relies on eastl::VectorBase::internalAllocator");
+			static_assert(std::is_convertible_v<decltype(this->GetNewCapacity(size_type(0))), size_type>,
+						  "Vector relies on eastl::VectorBase::GetNewCapacity");
+
+			if constexpr (Detail::CanTryExpand<Allocator>::value)
+			{
+				if (this->mpBegin != nullptr &&
+					this->internalAllocator().try_expand(this->mpBegin, this->capacity() * sizeof(T), newCapacity * sizeof(T)))
+				{
+					this->internalCapacityPtr() = this->mpBegin + newCapacity;
+				}
+			}
+		}
+	};
 
-} // namespace QMBT
\ No newline at end of file
+} // namespace QMBT
@@ -6,6 +6,8 @@
 #include "Core/Logging/Logger.hpp"
 #include "Core/Macros.hpp"
 #include "Core/Types/Array.hpp"
+#include "Core/Types/FixedString.hpp"
+#include "Core/Types/FixedVector.hpp"
 #include "Core/Types/String.hpp"
 #include "Core/Types/Vector.hpp"
 
@@ -49,12 +51,16 @@ namespace QMBT
 
 	struct Frame
 	{
-		Vector<Vector<ProfileData>> Data;
+		// One row per level of nesting. Most frames are only a few levels deep, so their rows are kept inline
+		// and recording or copying a frame only allocates the rows themselves.
+		static constexpr Size INLINE_ROW_COUNT = 4;
+
+		FixedVector<Vector<ProfileData>, INLINE_ROW_COUNT> Data;
 	};
 
 	struct InstrumentationSession
 	{
-		String Name;
+		FixedString<64> Name;
 	};
 
 	using TimesArray = Array<Vector<double>, static_cast<int>(ProfileCategory::Other) + 1>;
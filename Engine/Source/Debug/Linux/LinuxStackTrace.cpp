@@ -0,0 +1,61 @@
+#include "QMBTPCH.hpp"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+#include "../StackTrace.hpp"
+
+namespace QMBT
+{
+	namespace
+	{
+		constexpr Size s_MaxCapturedFrames = 64;
+	} // namespace
+
+	Size StackTrace::Capture(void** frames, const Size maxFrames, const Size skipFrames)
+	{
+		// The frame of Capture itself is always skipped
+		void* captured[s_MaxCapturedFrames];
+		const Size count = backtrace(captured, (int)std::min(maxFrames + skipFrames + 1, s_MaxCapturedFrames));
+		if (count <= skipFrames + 1)
+		{
+			return 0;
+		}
+
+		const Size frameCount = std::min(count - skipFrames - 1, maxFrames);
+		std::copy(captured + skipFrames + 1, captured + skipFrames + 1 + frameCount, frames);
+		return frameCount;
+	}
+
+	std::string StackTrace::GetSymbol(const void* address)
+	{
+		std::stringstream stream;
+
+		Dl_info info;
+		if (dladdr(address, &info) == 0)
+		{
+			stream << address;
+			return stream.str();
+		}
+
+		if (info.dli_sname != nullptr)
+		{
+			int status;
+			char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+			stream << (status == 0 ? demangled : info.dli_sname) << "+0x" << std::hex << ((Size)address - (Size)info.dli_saddr);
+			free(demangled);
+		}
+		else
+		{
+			stream << address;
+		}
+
+		if (info.dli_fname != nullptr)
+		{
+			stream << " (" << info.dli_fname << ")";
+		}
+
+		return stream.str();
+	}
+} // namespace QMBT
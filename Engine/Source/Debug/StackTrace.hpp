@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QMBTPCH.hpp>
+
+#include "Core/Aliases.hpp"
+
+namespace QMBT
+{
+	/**
+	 * @brief Walks and symbolizes the call stack of the calling thread.
+	 * @details Capturing only stores return addresses, so it can run inside an allocator. The very first capture
+	 * loads the unwinder, which allocates from the system heap. Turning the addresses into names is much slower
+	 * and should only happen when they are reported.
+	 *
+	 */
+	class StackTrace
+	{
+	  public:
+		/**
+		 * @brief Stores the return addresses of the calling function and its callers, innermost first
+		 *
+		 * @param skipFrames How many of the innermost callers to leave out, not counting Capture itself
+		 * @return Size The number of frames that were stored, at most maxFrames
+		 */
+		static Size Capture(void** frames, const Size maxFrames, const Size skipFrames = 0);
+
+		/**
+		 * @brief Describes an address returned by Capture
+		 *
+		 * @return std::string The demangled name of the function and the offset into it, followed by the
+		 * module, or just the address and the module if the function has no symbol
+		 */
+		static std::string GetSymbol(const void* address);
+	};
+} // namespace QMBT
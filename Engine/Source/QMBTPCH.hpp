@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
@@ -14,6 +15,7 @@
 #include <type_traits>
 #include <utility>
 
+#include <array>
 #include <bitset>
 #include <deque>
 #include <map>
@@ -36,6 +38,9 @@
 #define EASTL_USER_CONFIG_HEADER "Core/CoreConfig.hpp"
 
 #include <EASTL/array.h>
+#include <EASTL/fixed_hash_map.h>
+#include <EASTL/fixed_string.h>
+#include <EASTL/fixed_vector.h>
 #include <EASTL/shared_ptr.h>
 #include <EASTL/string.h>
 #include <EASTL/unique_ptr.h>
@@ -0,0 +1,80 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace QMBT;
+
+TEST_CASE("AllocationTagRegistry Interning Test", "[Memory]")
+{
+	const AllocationTag tag = AllocationTag("Tag Test Meshes");
+
+	REQUIRE(tag.IsTagged());
+	REQUIRE(strcmp(AllocationTagRegistry::GetName(tag.GetID()), "Tag Test Meshes") == 0);
+	REQUIRE(tag.GetID() < AllocationTagRegistry::GetTagCount());
+
+	SECTION("Same Name")
+	{
+		// Names are compared by content, not by address
+		char name[] = "Tag Test Meshes";
+		REQUIRE(AllocationTag(name).GetID() == tag.GetID());
+	}
+
+	SECTION("Different Name")
+	{
+		REQUIRE(AllocationTag("Tag Test Textures").GetID() != tag.GetID());
+	}
+
+	SECTION("Empty Name")
+	{
+		REQUIRE_FALSE(AllocationTag("").IsTagged());
+		REQUIRE_FALSE(AllocationTag().IsTagged());
+	}
+}
+
+TEST_CASE("Tagged Allocation Test", "[Memory]")
+{
+	const AllocationTag tag = AllocationTag("Tag Test Allocations");
+
+	SECTION("FreeListAllocator")
+	{
+		FreeListAllocator allocator = FreeListAllocator("FreeList Allocator", 1_MB);
+		const AllocatorData& data = allocator.GetAllocatorData();
+
+		void* ptr = allocator.Allocate(100, 8, tag);
+		void* untagged = allocator.Allocate(100);
+
+		// Blocks are counted with their header and padding
+		REQUIRE(data.TaggedSizes[tag.GetID()] >= 100);
+		REQUIRE(data.TaggedSizes[tag.GetID()] < allocator.GetUsedSize());
+
+		allocator.Deallocate(ptr, tag);
+		allocator.Deallocate(untagged);
+
+		REQUIRE(data.TaggedSizes[tag.GetID()] == 0);
+	}
+
+	SECTION("ThreadCachedAllocator")
+	{
+		ThreadCachedAllocator allocator = ThreadCachedAllocator("ThreadCached Allocator", 10_MB);
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; t++)
+		{
+			threads.emplace_back([&allocator, &tag] {
+				for (int i = 0; i < 1000; i++)
+				{
+					allocator.Deallocate(allocator.Allocate(64, 8, tag), 64, tag);
+				}
+			});
+		}
+		void* ptr = allocator.Allocate(5000, 8, tag);
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		REQUIRE(allocator.GetAllocatorData().TaggedSizes[tag.GetID()] == 5000);
+
+		allocator.Deallocate(ptr, 5000, tag);
+	}
+}
@@ -0,0 +1,197 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "Debug/StackTrace.hpp"
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+namespace
+{
+	// Every test starts with an empty tracker, and leaves tracking off for the others
+	struct TrackingScope
+	{
+		TrackingScope(const Size sampleInterval)
+		{
+			AllocationTracker::Clear();
+			AllocationTracker::Enable(sampleInterval);
+		}
+
+		~TrackingScope()
+		{
+			AllocationTracker::Disable();
+			AllocationTracker::Clear();
+		}
+	};
+} // namespace
+
+TEST_CASE("AllocationTracker Disabled Test", "[Memory]")
+{
+	AllocationTracker::Clear();
+
+	FreeListAllocator allocator = FreeListAllocator("FreeList Allocator", 1_MB);
+	void* ptr = allocator.Allocate(100);
+
+	REQUIRE_FALSE(AllocationTracker::IsEnabled());
+	REQUIRE(AllocationTracker::GetLiveSampleCount() == 0);
+
+	allocator.Deallocate(ptr);
+}
+
+TEST_CASE("AllocationTracker Live Allocation Test", "[Memory]")
+{
+	TrackingScope scope(1);
+
+	SECTION("FreeListAllocator")
+	{
+		FreeListAllocator allocator = FreeListAllocator("FreeList Allocator", 1_MB);
+		const AllocatorData* data = &allocator.GetAllocatorData();
+
+		std::vector<void*> ptrs;
+		for (int i = 0; i < 10; i++)
+		{
+			ptrs.push_back(allocator.Allocate(100));
+		}
+		REQUIRE(AllocationTracker::GetLiveSampleCount(data) == 10);
+
+		for (int i = 0; i < 5; i++)
+		{
+			allocator.Deallocate(ptrs[i]);
+		}
+		REQUIRE(AllocationTracker::GetLiveSampleCount(data) == 5);
+
+		// Freeing everything at once forgets the rest
+		allocator.Reset();
+		REQUIRE(AllocationTracker::GetLiveSampleCount(data) == 0);
+	}
+
+	SECTION("StackAllocator")
+	{
+		StackAllocator allocator = StackAllocator("Stack Allocator", 1_MB);
+
+		void* first = allocator.Allocate(100);
+		allocator.Allocate(100);
+		void* third = allocator.Allocate(100);
+		allocator.Allocate(100);
+		REQUIRE(AllocationTracker::GetLiveSampleCount() == 4);
+
+		// Frees the allocations above it too
+		allocator.Deallocate((Size)third);
+		REQUIRE(AllocationTracker::GetLiveSampleCount() == 2);
+
+		allocator.Deallocate((Size)first);
+		REQUIRE(AllocationTracker::GetLiveSampleCount() == 0);
+	}
+
+	SECTION("PoolAllocator")
+	{
+		PoolAllocator<TestObject> allocator = PoolAllocator<TestObject>("Pool Allocator", 50);
+
+		TestObject* first = allocator.New(1, 2.0f, 'c', false, 5.0f);
+		TestObject* second = allocator.New(1, 2.0f, 'c', false, 5.0f);
+		REQUIRE(AllocationTracker::GetLiveSampleCount() == 2);
+
+		allocator.Delete(first);
+		REQUIRE(AllocationTracker::GetLiveSampleCount() == 1);
+
+		allocator.Delete(second);
+		REQUIRE(AllocationTracker::GetLiveSampleCount() == 0);
+	}
+
+	SECTION("ThreadCachedAllocator")
+	{
+		ThreadCachedAllocator allocator = ThreadCachedAllocator("ThreadCached Allocator", 10_MB);
+		const AllocatorData* data = &allocator.GetAllocatorData();
+
+		// The caches refill from the heap in batches, which must not be counted as allocations
+		void* small = allocator.Allocate(64);
+		void* large = allocator.Allocate(64_KB);
+		REQUIRE(AllocationTracker::GetLiveSampleCount(data) == 2);
+
+		allocator.Deallocate(small, 64);
+		allocator.Deallocate(large, 64_KB);
+		REQUIRE(AllocationTracker::GetLiveSampleCount(data) == 0);
+	}
+
+	SECTION("Destroyed Allocator")
+	{
+		{
+			FreeListAllocator allocator = FreeListAllocator("FreeList Allocator", 1_MB);
+			allocator.Allocate(100);
+			REQUIRE(AllocationTracker::GetLiveSampleCount() == 1);
+		}
+		REQUIRE(AllocationTracker::GetLiveSampleCount() == 0);
+	}
+}
+
+TEST_CASE("AllocationTracker Site Test", "[Memory]")
+{
+	TrackingScope scope(1);
+
+	FreeListAllocator allocator = FreeListAllocator("FreeList Allocator", 1_MB);
+
+	std::vector<void*> ptrs;
+	for (int i = 0; i < 8; i++)
+	{
+		ptrs.push_back(allocator.Allocate(256));
+	}
+	void* other = allocator.Allocate(16);
+
+	for (int i = 0; i < 6; i++)
+	{
+		allocator.Deallocate(ptrs[i]);
+	}
+
+	const std::vector<AllocationTracker::SiteReport> sites = AllocationTracker::GetTopSites(10);
+	REQUIRE(sites.size() == 2);
+
+	// The loop allocated the most, so it comes first
+	REQUIRE(sites[0].AllocationCount == 8);
+	REQUIRE(sites[0].AllocatedSize == 8 * 256);
+	REQUIRE(sites[0].LiveCount == 2);
+	REQUIRE(sites[0].LiveSize == 2 * 256);
+	REQUIRE(sites[0].FrameCount > 0);
+	REQUIRE_FALSE(StackTrace::GetSymbol(sites[0].Frames[0]).empty());
+
+	REQUIRE(sites[1].AllocationCount == 1);
+	REQUIRE(sites[1].LiveSize == 16);
+
+	SECTION("Resize")
+	{
+		REQUIRE(allocator.TryExpand(other, 32));
+		REQUIRE(AllocationTracker::GetTopSites(1, true)[0].LiveSize == 2 * 256);
+		REQUIRE(AllocationTracker::GetTopSites(2, true)[1].LiveSize == 32);
+	}
+
+	SECTION("Live Only")
+	{
+		allocator.Deallocate(ptrs[6]);
+		allocator.Deallocate(ptrs[7]);
+
+		const std::vector<AllocationTracker::SiteReport> liveSites = AllocationTracker::GetTopSites(10, true);
+		REQUIRE(liveSites.size() == 1);
+		REQUIRE(liveSites[0].LiveSize == 16);
+	}
+}
+
+TEST_CASE("AllocationTracker Sampling Test", "[Memory]")
+{
+	const Size sampleInterval = 16;
+	TrackingScope scope(sampleInterval);
+
+	ThreadCachedAllocator allocator = ThreadCachedAllocator("ThreadCached Allocator", 10_MB);
+
+	const Size allocationCount = 16000;
+	for (Size i = 0; i < allocationCount; i++)
+	{
+		allocator.Deallocate(allocator.Allocate(128), 128);
+	}
+
+	// The estimate is the number of samples times the interval
+	const std::vector<AllocationTracker::SiteReport> sites = AllocationTracker::GetTopSites(1);
+	REQUIRE(sites.size() == 1);
+	REQUIRE(sites[0].AllocationCount > allocationCount * 3 / 4);
+	REQUIRE(sites[0].AllocationCount < allocationCount * 5 / 4);
+	REQUIRE(sites[0].AllocatedSize == sites[0].AllocationCount * 128);
+	REQUIRE(sites[0].LiveCount == 0);
+}
@@ -0,0 +1,65 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+TEST_CASE("DoubleBufferedAllocator Lifetime Test", "[Memory]")
+{
+	DoubleBufferedAllocator allocator("Double Buffered Allocator", 8_MB);
+
+	TestObject* object = allocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+	REQUIRE(allocator.IsLive(object));
+
+	// Still there in the next frame
+	allocator.SwapBuffers();
+	REQUIRE(allocator.IsLive(object));
+	REQUIRE(object->a == 1);
+	REQUIRE(object->e == 10.6f);
+
+	TestObject* nextObject = allocator.New<TestObject>(2, 2.1f, 'a', false, 10.6f);
+	REQUIRE(allocator.GetPreviousBuffer().Contains(object));
+	REQUIRE(allocator.GetCurrentBuffer().Contains(nextObject));
+
+	// Gone the frame after
+	allocator.SwapBuffers();
+	REQUIRE_FALSE(allocator.IsLive(object));
+	REQUIRE(allocator.IsLive(nextObject));
+	REQUIRE(nextObject->a == 2);
+
+#ifdef QMBT_DEBUG
+	REQUIRE(((UInt8*)object)[0] == DoubleBufferedAllocator::FREED_PATTERN);
+#endif
+
+	allocator.SwapBuffers();
+	REQUIRE(allocator.GetUsedSize() == 0);
+}
+
+TEST_CASE("DoubleBufferedAllocator Top Allocation Test", "[Memory]")
+{
+	DoubleBufferedAllocator allocator("Double Buffered Allocator", 8_MB);
+
+	// Both ends of the current buffer live for two frames
+	TestObject* bottomObject = allocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+	TestObject* topObject = new (allocator.GetCurrentBuffer().AllocateTop(sizeof(TestObject), alignof(TestObject)))
+		TestObject(2, 2.1f, 'a', false, 10.6f);
+	REQUIRE(allocator.IsLive(bottomObject));
+	REQUIRE(allocator.IsLive(topObject));
+
+	allocator.SwapBuffers();
+	REQUIRE(allocator.IsLive(topObject));
+	REQUIRE(topObject->a == 2);
+
+	allocator.SwapBuffers();
+	REQUIRE_FALSE(allocator.IsLive(bottomObject));
+	REQUIRE_FALSE(allocator.IsLive(topObject));
+
+#ifdef QMBT_DEBUG
+	REQUIRE(((UInt8*)bottomObject)[0] == DoubleBufferedAllocator::FREED_PATTERN);
+	REQUIRE(((UInt8*)topObject)[0] == DoubleBufferedAllocator::FREED_PATTERN);
+	REQUIRE(((UInt8*)topObject)[sizeof(TestObject) - 1] == DoubleBufferedAllocator::FREED_PATTERN);
+#endif
+
+	REQUIRE(allocator.GetUsedSize() == 0);
+}
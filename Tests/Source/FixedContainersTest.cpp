@@ -0,0 +1,76 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace QMBT;
+
+// Every container overflows to its own FreeListAllocator, so the tests can see exactly when it allocates
+TEST_CASE("FixedVector Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator("FreeList Allocator", 1_MB);
+	AllocatorResource<FreeListAllocator> resource(freeListAllocator);
+
+	{
+		FixedVector<int, 8> vec;
+		vec.set_overflow_allocator(STLAllocator("Overflow", &resource));
+
+		for (int i = 0; i < 8; i++)
+		{
+			vec.push_back(i);
+		}
+		REQUIRE(freeListAllocator.GetUsedSize() == 0);
+
+		vec.push_back(8);
+		REQUIRE(vec.has_overflowed());
+		REQUIRE(freeListAllocator.GetUsedSize() > 0);
+		for (int i = 0; i < 9; i++)
+		{
+			REQUIRE(vec[i] == i);
+		}
+	}
+
+	REQUIRE(freeListAllocator.GetUsedSize() == 0);
+}
+
+TEST_CASE("FixedString Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator("FreeList Allocator", 1_MB);
+	AllocatorResource<FreeListAllocator> resource(freeListAllocator);
+
+	{
+		FixedString<32> name;
+		name.set_overflow_allocator(STLAllocator("Overflow", &resource));
+
+		name = "Fits in the inline buffer";
+		REQUIRE(freeListAllocator.GetUsedSize() == 0);
+
+		name += ", and this does not any more";
+		REQUIRE(freeListAllocator.GetUsedSize() > 0);
+		REQUIRE(name == "Fits in the inline buffer, and this does not any more");
+	}
+
+	REQUIRE(freeListAllocator.GetUsedSize() == 0);
+}
+
+TEST_CASE("FixedHashMap Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator("FreeList Allocator", 1_MB);
+	AllocatorResource<FreeListAllocator> resource(freeListAllocator);
+
+	{
+		FixedHashMap<int, float, 16> map;
+		map.set_overflow_allocator(STLAllocator("Overflow", &resource));
+
+		for (int i = 0; i < 16; i++)
+		{
+			map[i] = i * 0.5f;
+		}
+		REQUIRE(freeListAllocator.GetUsedSize() == 0);
+
+		map[16] = 8.0f;
+		REQUIRE(freeListAllocator.GetUsedSize() > 0);
+		REQUIRE(map.size() == 17);
+		REQUIRE(map[3] == 1.5f);
+	}
+
+	REQUIRE(freeListAllocator.GetUsedSize() == 0);
+}
@@ -0,0 +1,49 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+TEST_CASE("FrameAllocator Frame Test", "[Memory]")
+{
+	FrameAllocator allocator("Frame Allocator", 8_MB);
+
+	// A frame that uses more than the next one, the high-water mark is the one of the last frame only
+	for (int i = 0; i < 100; i++)
+	{
+		TestObject* object = allocator.New<TestObject>(i, 2.1f, 'a', false, 10.6f);
+		REQUIRE(object->a == i);
+	}
+	const Size firstFrameSize = allocator.GetUsedSize();
+
+	allocator.EndFrame();
+	REQUIRE(allocator.GetUsedSize() == 0);
+	REQUIRE(allocator.GetLastFramePeakSize() == firstFrameSize);
+
+	allocator.Allocate(64);
+	{
+		StackAllocatorScope scope(allocator.GetStackAllocator());
+		allocator.Allocate(1_KB);
+	}
+	const Size secondFrameSize = allocator.GetUsedSize();
+
+	allocator.EndFrame();
+	REQUIRE(allocator.GetLastFramePeakSize() > secondFrameSize);
+	REQUIRE(allocator.GetLastFramePeakSize() < firstFrameSize);
+}
+
+TEST_CASE("FrameAllocator Commit Test", "[Memory]")
+{
+	FrameAllocator allocator("Frame Allocator", 16_MB);
+
+	// A frame as large as the last one finds its pages still committed
+	memset(allocator.Allocate(4_MB), 1, 4_MB);
+	allocator.EndFrame();
+	REQUIRE(allocator.GetStackAllocator().GetCommittedSize() >= 4_MB);
+
+	// Once the frames get smaller, the pages above them are given back
+	allocator.Allocate(64);
+	allocator.EndFrame();
+	REQUIRE(allocator.GetStackAllocator().GetCommittedSize() < 4_MB);
+}
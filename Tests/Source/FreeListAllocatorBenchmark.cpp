@@ -0,0 +1,92 @@
+#include <vector>
+
+#include <Qombat/Tests.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace QMBT;
+
+namespace
+{
+	constexpr int s_NumFragments = 10000;
+
+	// Fills the start of the heap with small blocks and frees every other one, leaving
+	// s_NumFragments free blocks that are too small for the benchmarked allocations.
+	// Returns the blocks that are still allocated.
+	std::vector<void*> Fragment(FreeListAllocator& allocator)
+	{
+		std::vector<void*> ptrs;
+		for (int i = 0; i < s_NumFragments * 2; i++)
+		{
+			ptrs.push_back(allocator.Allocate(16 + (i * 8) % 240));
+		}
+
+		std::vector<void*> livePtrs;
+		for (int i = 0; i < s_NumFragments * 2; i += 2)
+		{
+			allocator.Deallocate(ptrs[i]);
+			livePtrs.push_back(ptrs[i + 1]);
+		}
+
+		return livePtrs;
+	}
+
+	void BenchmarkFragmentedAllocation(Catch::Benchmark::Chronometer& meter, FreeListAllocator::PlacementPolicy policy)
+	{
+		FreeListAllocator allocator("Benchmark Allocator", 16_MB, policy);
+		Fragment(allocator);
+
+		// Freeing the block straight away keeps the heap in the same shape for every run
+		meter.measure([&] { allocator.Deallocate(allocator.Allocate(512)); });
+	}
+
+	// Replaces a pseudo-randomly chosen live block of a fragmented heap on every run, the way
+	// containers going through STLAllocator grow and shrink
+	void BenchmarkChurn(Catch::Benchmark::Chronometer& meter, FreeListAllocator::PlacementPolicy policy)
+	{
+		FreeListAllocator allocator("Benchmark Allocator", 16_MB, policy);
+		std::vector<void*> ptrs = Fragment(allocator);
+
+		meter.measure([&](int i) {
+			const Size slot = (Size(i) * 2654435761u) % ptrs.size();
+			allocator.Deallocate(ptrs[slot]);
+			ptrs[slot] = allocator.Allocate(16 + (i * 24) % 240);
+		});
+	}
+} // namespace
+
+TEST_CASE("FreeListAllocator Fragmented Allocation Benchmark", "[Memory][!benchmark]")
+{
+	BENCHMARK_ADVANCED("Find First")(Catch::Benchmark::Chronometer meter)
+	{
+		BenchmarkFragmentedAllocation(meter, FreeListAllocator::FIND_FIRST);
+	};
+
+	BENCHMARK_ADVANCED("Find Best")(Catch::Benchmark::Chronometer meter)
+	{
+		BenchmarkFragmentedAllocation(meter, FreeListAllocator::FIND_BEST);
+	};
+
+	BENCHMARK_ADVANCED("Find Segregated")(Catch::Benchmark::Chronometer meter)
+	{
+		BenchmarkFragmentedAllocation(meter, FreeListAllocator::FIND_SEGREGATED);
+	};
+}
+
+TEST_CASE("FreeListAllocator Churn Benchmark", "[Memory][!benchmark]")
+{
+	BENCHMARK_ADVANCED("Find First")(Catch::Benchmark::Chronometer meter)
+	{
+		BenchmarkChurn(meter, FreeListAllocator::FIND_FIRST);
+	};
+
+	BENCHMARK_ADVANCED("Find Best")(Catch::Benchmark::Chronometer meter)
+	{
+		BenchmarkChurn(meter, FreeListAllocator::FIND_BEST);
+	};
+
+	BENCHMARK_ADVANCED("Find Segregated")(Catch::Benchmark::Chronometer meter)
+	{
+		BenchmarkChurn(meter, FreeListAllocator::FIND_SEGREGATED);
+	};
+}
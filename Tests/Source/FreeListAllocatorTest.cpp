@@ -119,3 +119,435 @@ TEST_CASE("FreeListAllocator Reallocation Test", "[Memory]")
 		REQUIRE(object2New->e.size() == 6);
 	}
 }
+
+TEST_CASE("Segregated FreeListAllocator Allocation Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 10_MB, FreeListAllocator::FIND_SEGREGATED);
+
+	SECTION("Multiple Objects")
+	{
+		TestObject* object = freeListAllocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+		TestObject2* object2 = freeListAllocator.New<TestObject2>(2, 5.4, 8.2, false, std::vector<int>(6));
+
+		REQUIRE(object->a == 1);
+		REQUIRE(object->b == 2.1f);
+		REQUIRE(object->c == 'a');
+		REQUIRE(object->d == false);
+		REQUIRE(object->e == 10.6f);
+
+		REQUIRE(object2->a == 2);
+		REQUIRE(object2->b == 5.4);
+		REQUIRE(object2->c == 8.2);
+		REQUIRE(object2->d == false);
+		REQUIRE(object2->e.size() == 6);
+	}
+
+	SECTION("Alignment")
+	{
+		for (Size alignment = 8; alignment <= 256; alignment *= 2)
+		{
+			void* ptr = freeListAllocator.Allocate(24, alignment);
+
+			REQUIRE((Size)ptr % alignment == 0);
+		}
+	}
+}
+
+TEST_CASE("Segregated FreeListAllocator Deallocation Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 10_MB, FreeListAllocator::FIND_SEGREGATED);
+	std::vector<void*> ptrs;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		ptrs.push_back(freeListAllocator.Allocate(8 + (i * 37) % 2000));
+	}
+
+	SECTION("Normal Order")
+	{
+		for (void* ptr : ptrs)
+		{
+			freeListAllocator.Deallocate(ptr);
+		}
+	}
+
+	SECTION("Reverse Order")
+	{
+		for (auto it = ptrs.rbegin(); it != ptrs.rend(); ++it)
+		{
+			freeListAllocator.Deallocate(*it);
+		}
+	}
+
+	SECTION("Interleaved Order")
+	{
+		for (Size i = 0; i < ptrs.size(); i += 2)
+		{
+			freeListAllocator.Deallocate(ptrs[i]);
+		}
+		for (Size i = 1; i < ptrs.size(); i += 2)
+		{
+			freeListAllocator.Deallocate(ptrs[i]);
+		}
+	}
+
+	REQUIRE(freeListAllocator.GetUsedSize() == 0);
+
+	// All the blocks should have merged back into one, so almost the whole region can be allocated again
+	void* ptr = freeListAllocator.Allocate(9_MB);
+	REQUIRE(ptr != nullptr);
+}
+
+TEST_CASE("Best Fit FreeListAllocator Placement Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 10_MB, FreeListAllocator::FIND_BEST);
+
+	// Leave holes of three different sizes, each kept apart by an allocated block
+	void* small = freeListAllocator.Allocate(100);
+	freeListAllocator.Allocate(8);
+	void* large = freeListAllocator.Allocate(300);
+	freeListAllocator.Allocate(8);
+	void* medium = freeListAllocator.Allocate(200);
+	freeListAllocator.Allocate(8);
+
+	freeListAllocator.Deallocate(small);
+	freeListAllocator.Deallocate(large);
+	freeListAllocator.Deallocate(medium);
+
+	SECTION("Tightest Fit")
+	{
+		REQUIRE(freeListAllocator.Allocate(180) == medium);
+		REQUIRE(freeListAllocator.Allocate(250) == large);
+		REQUIRE(freeListAllocator.Allocate(90) == small);
+	}
+
+	SECTION("Over-aligned Fit")
+	{
+		void* ptr = freeListAllocator.Allocate(150, 64);
+
+		// The small hole is too small, so the data has to land in one of the other two instead of the tail
+		REQUIRE((Size)ptr % 64 == 0);
+		REQUIRE((char*)ptr > (char*)large);
+		REQUIRE((char*)ptr < (char*)medium + 200);
+	}
+}
+
+TEST_CASE("Fixed FreeListAllocator Out Of Memory Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 64_KB);
+
+	REQUIRE(freeListAllocator.Allocate(128_KB) == nullptr);
+	REQUIRE(freeListAllocator.New<std::array<UInt8, 128_KB>>() == nullptr);
+	REQUIRE(freeListAllocator.GetTotalSize() == 64_KB);
+}
+
+TEST_CASE("Segregated FreeListAllocator Size Limit Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 64_KB, FreeListAllocator::FIND_SEGREGATED, ResizePolicy::Resizable);
+
+	const bool logMemory = Logger::s_LogMemoryOn;
+	Logger::s_LogMemoryOn = false;
+
+	// Past the largest block the bins can hold, so no region is mapped for it
+	REQUIRE(freeListAllocator.Allocate(Size(1) << 41) == nullptr);
+	REQUIRE(freeListAllocator.GetTotalSize() == 64_KB);
+
+	Logger::s_LogMemoryOn = logMemory;
+}
+
+TEST_CASE("Resizable FreeListAllocator Test", "[Memory]")
+{
+	FreeListAllocator::PlacementPolicy policy = FreeListAllocator::FIND_FIRST;
+
+	SECTION("Find First")
+	{
+		policy = FreeListAllocator::FIND_FIRST;
+	}
+
+	SECTION("Find Best")
+	{
+		policy = FreeListAllocator::FIND_BEST;
+	}
+
+	SECTION("Find Segregated")
+	{
+		policy = FreeListAllocator::FIND_SEGREGATED;
+	}
+
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 64_KB, policy, ResizePolicy::Resizable);
+	freeListAllocator.SetRegionIdleTime(std::chrono::milliseconds(0));
+
+	// Fill several regions, plus one allocation that is larger than a whole region
+	std::vector<TestObject*> objects;
+	for (int i = 0; i < 10000; i++)
+	{
+		objects.push_back(freeListAllocator.New<TestObject>(i, 2.1f, 'a', false, 10.6f));
+	}
+	void* large = freeListAllocator.Allocate(1_MB, 64);
+
+	REQUIRE(large != nullptr);
+	REQUIRE((Size)large % 64 == 0);
+	REQUIRE(freeListAllocator.GetTotalSize() > 1_MB);
+
+	for (int i = 0; i < 10000; i++)
+	{
+		REQUIRE(objects[i]->a == i);
+	}
+
+	SECTION("Regions In Use Are Kept")
+	{
+		const Size totalSize = freeListAllocator.GetTotalSize();
+		freeListAllocator.ReleaseIdleRegions();
+
+		REQUIRE(freeListAllocator.GetTotalSize() == totalSize);
+	}
+
+	SECTION("Empty Regions Are Released")
+	{
+		for (TestObject* object : objects)
+		{
+			freeListAllocator.Delete(object);
+		}
+		freeListAllocator.Deallocate(large);
+		freeListAllocator.ReleaseIdleRegions();
+
+		REQUIRE(freeListAllocator.GetUsedSize() == 0);
+		REQUIRE(freeListAllocator.GetTotalSize() == 64_KB);
+	}
+}
+
+TEST_CASE("Page Backed FreeListAllocator Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 16_MB, FreeListAllocator::FIND_SEGREGATED, ResizePolicy::Fixed, BackingPolicy::Pages);
+
+	// Only the pages holding the boundary tags of the free block are committed
+	REQUIRE(freeListAllocator.GetCommittedSize() < 64_KB);
+
+	TestObject* object = freeListAllocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+	void* large = freeListAllocator.Allocate(8_MB);
+	memset(large, 1, 8_MB);
+
+	REQUIRE(freeListAllocator.GetCommittedSize() >= 8_MB);
+
+	SECTION("Small Frees Keep Pages")
+	{
+		const Size committedSize = freeListAllocator.GetCommittedSize();
+		freeListAllocator.Delete(object);
+
+		REQUIRE(freeListAllocator.GetCommittedSize() == committedSize);
+	}
+
+	SECTION("Large Frees Give Pages Back")
+	{
+		freeListAllocator.Deallocate(large);
+
+		REQUIRE(freeListAllocator.GetCommittedSize() < 64_KB);
+		REQUIRE(object->a == 1);
+	}
+}
+
+TEST_CASE("FreeListAllocator In Place Resize Test", "[Memory]")
+{
+	FreeListAllocator::PlacementPolicy policy = FreeListAllocator::FIND_FIRST;
+
+	SECTION("Find First")
+	{
+		policy = FreeListAllocator::FIND_FIRST;
+	}
+
+	SECTION("Find Best")
+	{
+		policy = FreeListAllocator::FIND_BEST;
+	}
+
+	SECTION("Find Segregated")
+	{
+		policy = FreeListAllocator::FIND_SEGREGATED;
+	}
+
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 1_MB, policy);
+
+	UInt8* first = (UInt8*)freeListAllocator.Allocate(64);
+	void* second = freeListAllocator.Allocate(64);
+	void* third = freeListAllocator.Allocate(64);
+	memset(first, 7, 64);
+
+	// The block after the first one is free, but the one after that is not
+	freeListAllocator.Deallocate(second);
+	const Size usedSize = freeListAllocator.GetUsedSize();
+
+	REQUIRE(freeListAllocator.TryExpand(first, 128));
+	REQUIRE(freeListAllocator.GetUsedSize() > usedSize);
+	REQUIRE(first[0] == 7);
+	REQUIRE(first[63] == 7);
+
+	REQUIRE_FALSE(freeListAllocator.TryExpand(first, 1024));
+
+	// Shrinking gives the freed bytes back, and they can be used again right away
+	REQUIRE(freeListAllocator.TryExpand(first, 16));
+	REQUIRE(freeListAllocator.GetUsedSize() < usedSize);
+	REQUIRE(freeListAllocator.TryExpand(first, 128));
+
+	UInt8* moved = (UInt8*)freeListAllocator.Reallocate(first, 4096);
+
+	REQUIRE(moved != first);
+	REQUIRE(moved[0] == 7);
+	REQUIRE(moved[63] == 7);
+
+	freeListAllocator.Deallocate(moved);
+	freeListAllocator.Deallocate(third);
+
+	REQUIRE(freeListAllocator.GetUsedSize() == 0);
+}
+
+TEST_CASE("FreeListAllocator Fragmentation Statistics Test", "[Memory]")
+{
+	FreeListAllocator::PlacementPolicy policy = FreeListAllocator::FIND_FIRST;
+
+	SECTION("Find First")
+	{
+		policy = FreeListAllocator::FIND_FIRST;
+	}
+
+	SECTION("Find Best")
+	{
+		policy = FreeListAllocator::FIND_BEST;
+	}
+
+	SECTION("Find Segregated")
+	{
+		policy = FreeListAllocator::FIND_SEGREGATED;
+	}
+
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 1_MB, policy);
+	const AllocatorData& data = freeListAllocator.GetAllocatorData();
+
+	REQUIRE(data.FreeBlockCount == 1);
+	REQUIRE(data.LargestFreeBlock == data.FreeSize);
+	REQUIRE(data.GetExternalFragmentation() == 0.0f);
+
+	const Size freeSize = data.FreeSize;
+
+	// Every other block is freed, which leaves holes that cannot merge
+	std::vector<void*> ptrs;
+	for (int i = 0; i < 100; i++)
+	{
+		ptrs.push_back(freeListAllocator.Allocate(64));
+	}
+	for (int i = 0; i < 100; i += 2)
+	{
+		freeListAllocator.Deallocate(ptrs[i]);
+	}
+
+	REQUIRE(data.FreeBlockCount == 51);
+	REQUIRE(data.FreeSize == freeSize - 50 * 80);
+	REQUIRE(data.LargestFreeBlock == freeSize - 100 * 80);
+	REQUIRE(data.FreeBlockHistogram[AllocatorData::GetHistogramBucket(80)] == 50);
+	REQUIRE(data.GetExternalFragmentation() > 0.0f);
+	REQUIRE(data.OverheadSize == 50 * 16);
+
+	// The largest block is split, and what is left of it is still the largest one
+	void* large = freeListAllocator.Allocate(64_KB);
+
+	REQUIRE(data.FreeBlockCount == 51);
+	REQUIRE(data.LargestFreeBlock == freeSize - 100 * 80 - (64_KB + 16));
+
+	freeListAllocator.Deallocate(large);
+	for (int i = 1; i < 100; i += 2)
+	{
+		freeListAllocator.Deallocate(ptrs[i]);
+	}
+
+	REQUIRE(data.FreeBlockCount == 1);
+	REQUIRE(data.FreeSize == freeSize);
+	REQUIRE(data.OverheadSize == 0);
+	REQUIRE(data.GetExternalFragmentation() == 0.0f);
+}
+
+TEST_CASE("FreeListAllocator Batch Test", "[Memory]")
+{
+	bool batchDeallocation = false;
+
+	SECTION("Single Deallocations")
+	{
+		batchDeallocation = false;
+	}
+
+	SECTION("Batch Deallocation")
+	{
+		batchDeallocation = true;
+	}
+
+	for (FreeListAllocator::PlacementPolicy policy : {FreeListAllocator::FIND_FIRST, FreeListAllocator::FIND_BEST, FreeListAllocator::FIND_SEGREGATED})
+	{
+		FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 1_MB, policy);
+		const AllocatorData& data = freeListAllocator.GetAllocatorData();
+		const Size freeSize = data.FreeSize;
+
+		std::vector<TestObject*> objectPtrs(100);
+		REQUIRE(freeListAllocator.NewN(objectPtrs.data(), 100, 1, 2.1f, 'a', true, 10.6f) == 100);
+
+		REQUIRE(data.UsedSize == freeSize - data.FreeSize);
+		REQUIRE(data.FreeBlockCount == 1);
+		for (TestObject* object : objectPtrs)
+		{
+			REQUIRE((Size)object % 8 == 0);
+			REQUIRE(object->a == 1);
+			REQUIRE(object->e == 10.6f);
+		}
+
+		if (batchDeallocation)
+		{
+			// Out of order, with a block that is not part of the batch in between
+			std::reverse(objectPtrs.begin(), objectPtrs.end());
+			freeListAllocator.Delete(objectPtrs[50]);
+			objectPtrs.erase(objectPtrs.begin() + 50);
+
+			freeListAllocator.DeleteN(objectPtrs.data(), objectPtrs.size());
+		}
+		else
+		{
+			for (TestObject* object : objectPtrs)
+			{
+				freeListAllocator.Delete(object);
+			}
+		}
+
+		REQUIRE(data.UsedSize == 0);
+		REQUIRE(data.OverheadSize == 0);
+		REQUIRE(data.FreeBlockCount == 1);
+		REQUIRE(data.FreeSize == freeSize);
+	}
+}
+
+TEST_CASE("FreeListAllocator Aligned Batch Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 64_KB);
+	const AllocatorData& data = freeListAllocator.GetAllocatorData();
+
+	std::vector<void*> ptrs(64);
+
+	SECTION("Aligned")
+	{
+		REQUIRE(freeListAllocator.AllocateN(ptrs.data(), 64, 40, 64) == 64);
+		for (void* ptr : ptrs)
+		{
+			REQUIRE((Size)ptr % 64 == 0);
+			memset(ptr, 0xFF, 40);
+		}
+	}
+
+	SECTION("Out Of Memory")
+	{
+		// The batch does not fit in one block, so as many blocks as possible are allocated one by one
+		const Size allocatedCount = freeListAllocator.AllocateN(ptrs.data(), 64, 2_KB);
+		REQUIRE(allocatedCount > 0);
+		REQUIRE(allocatedCount < 64);
+		ptrs.resize(allocatedCount);
+	}
+
+	freeListAllocator.DeallocateN(ptrs.data(), ptrs.size());
+
+	REQUIRE(data.UsedSize == 0);
+	REQUIRE(data.FreeBlockCount == 1);
+}
@@ -0,0 +1,119 @@
+#include <thread>
+#include <vector>
+
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+template <ResizePolicy Policy>
+using SharedPool = PoolAllocator<TestObject, Policy, ThreadingPolicy::MultiThreaded>;
+
+TEST_CASE("MultiThreadedPoolAllocator Allocation Test", "[Memory]")
+{
+	SharedPool<ResizePolicy::Fixed> poolAllocator{"Allocator", 50};
+	std::vector<TestObject*> objectPtrs = std::vector<TestObject*>();
+
+	for (int i = 0; i < 50; i++)
+	{
+		objectPtrs.push_back(poolAllocator.New(i, 2.1f + i, 'a' + i, i % 2, 10.6f + (2 * i)));
+	}
+
+	REQUIRE(poolAllocator.GetUsedSize() == 50 * sizeof(TestObject));
+	REQUIRE(poolAllocator.Allocate() == nullptr);
+
+	for (int i = 0; i < 50; i++)
+	{
+		REQUIRE(objectPtrs[i]->a == i);
+		REQUIRE(objectPtrs[i]->e == 10.6f + (2 * i));
+		poolAllocator.Delete(objectPtrs[i]);
+	}
+
+	REQUIRE(poolAllocator.GetUsedSize() == 0);
+
+	// Every chunk can be allocated again
+	for (int i = 0; i < 50; i++)
+	{
+		REQUIRE(poolAllocator.Allocate() != nullptr);
+	}
+}
+
+TEST_CASE("MultiThreadedPoolAllocator Batch Test", "[Memory]")
+{
+	SharedPool<ResizePolicy::Fixed> poolAllocator{"Allocator", 50};
+	std::vector<TestObject*> objectPtrs(60);
+
+	REQUIRE(poolAllocator.NewN(objectPtrs.data(), 60, 1, 2.1f, 'a', true, 10.6f) == 50);
+	REQUIRE(poolAllocator.GetUsedSize() == 50 * sizeof(TestObject));
+
+	poolAllocator.DeleteN(objectPtrs.data(), 50);
+	REQUIRE(poolAllocator.GetUsedSize() == 0);
+
+	// The whole batch went back to the shared free list
+	REQUIRE(poolAllocator.AllocateN(objectPtrs.data(), 60) == 50);
+}
+
+TEST_CASE("MultiThreadedPoolAllocator Concurrency Test", "[Memory]")
+{
+	SharedPool<ResizePolicy::Resizable> poolAllocator{"Allocator", 64};
+
+	SECTION("Same Thread")
+	{
+		// Catch assertions are not thread safe, so the threads only count what went wrong
+		std::atomic<int> wrongObjects{0};
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; t++)
+		{
+			threads.emplace_back([&poolAllocator, &wrongObjects, t] {
+				std::vector<TestObject*> objectPtrs;
+				for (int i = 0; i < 10000; i++)
+				{
+					objectPtrs.push_back(poolAllocator.New(t, 1.0f, 'a', false, (float)i));
+					if (objectPtrs.size() > 32)
+					{
+						// No other thread may have been handed the same chunk
+						wrongObjects += objectPtrs.front()->a != t;
+						poolAllocator.Delete(objectPtrs.front());
+						objectPtrs.erase(objectPtrs.begin());
+					}
+				}
+				for (TestObject* object : objectPtrs)
+				{
+					wrongObjects += object->a != t;
+					poolAllocator.Delete(object);
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		REQUIRE(wrongObjects == 0);
+	}
+
+	SECTION("Other Thread")
+	{
+		// Objects are created on a worker and destroyed on the main thread, the way loaded resources are
+		std::vector<TestObject*> objectPtrs(1000);
+		std::thread worker([&] {
+			for (int i = 0; i < 1000; i++)
+			{
+				objectPtrs[i] = poolAllocator.New(i, 1.0f, 'a', false, 1.0f);
+			}
+		});
+		worker.join();
+
+		for (int i = 0; i < 1000; i++)
+		{
+			REQUIRE(objectPtrs[i]->a == i);
+			poolAllocator.Delete(objectPtrs[i]);
+		}
+	}
+
+	REQUIRE(poolAllocator.GetUsedSize() == 0);
+}
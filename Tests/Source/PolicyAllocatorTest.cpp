@@ -0,0 +1,113 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+namespace
+{
+	using BareAllocator = PolicyAllocator<HeapBacking, NoLocking, NoStatistics, NoBoundsChecking, NoLogging>;
+	using TrackedAllocator = PolicyAllocator<HeapBacking, NoLocking, AllocatorStatistics, GuardBoundsChecking, MemoryLogging>;
+	using SharedAllocator = PolicyAllocator<HeapBacking, MutexLocking, AllocatorStatistics, GuardBoundsChecking, NoLogging>;
+
+	// Disabled policies take no room at all
+	static_assert(std::is_empty_v<BareAllocator>);
+	static_assert(sizeof(BareAllocator) == sizeof(HeapBacking));
+} // namespace
+
+TEST_CASE("PolicyAllocator Allocation Test", "[Memory]")
+{
+	SECTION("Without Policies")
+	{
+		BareAllocator allocator("Bare Allocator");
+
+		TestObject* object = allocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+		REQUIRE(object->a == 1);
+		REQUIRE(object->e == 10.6f);
+		allocator.Delete(object);
+	}
+
+	SECTION("Global Backing")
+	{
+		// TestObject is only 4 byte aligned, the small object allocator takes 8 at least
+		PolicyAllocator<GlobalBacking, NoLocking, NoStatistics, NoBoundsChecking, NoLogging> allocator("Global Allocator");
+
+		TestObject* object = allocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+		REQUIRE((Size)object % 8 == 0);
+		REQUIRE(object->a == 1);
+		allocator.Delete(object);
+	}
+
+	SECTION("With Policies")
+	{
+		TrackedAllocator allocator("Tracked Allocator");
+
+		std::vector<void*> ptrs;
+		for (Size size = 1; size <= 100; size++)
+		{
+			void* ptr = allocator.Allocate(size, 16);
+			REQUIRE((Size)ptr % 16 == 0);
+			memset(ptr, 0xAB, size);
+			ptrs.push_back(ptr);
+		}
+		REQUIRE(allocator.GetAllocatorData().UsedSize == 100 * 101 / 2);
+
+		for (Size size = 1; size <= 100; size++)
+		{
+			allocator.Deallocate(ptrs[size - 1], size);
+		}
+		REQUIRE(allocator.GetAllocatorData().UsedSize == 0);
+		REQUIRE(allocator.GetOverrunCount() == 0);
+	}
+}
+
+TEST_CASE("PolicyAllocator Bounds Checking Test", "[Memory]")
+{
+	TrackedAllocator allocator("Tracked Allocator");
+
+	const bool logMemory = Logger::s_LogMemoryOn;
+	Logger::s_LogMemoryOn = false;
+
+	SECTION("Overrun")
+	{
+		UInt8* ptr = (UInt8*)allocator.Allocate(32);
+		ptr[32] = 0;
+		allocator.Deallocate(ptr, 32);
+	}
+
+	SECTION("Underrun")
+	{
+		UInt8* ptr = (UInt8*)allocator.Allocate(32);
+		ptr[-1] = 0;
+		allocator.Deallocate(ptr, 32);
+	}
+
+	REQUIRE(allocator.GetOverrunCount() == 1);
+
+	Logger::s_LogMemoryOn = logMemory;
+}
+
+TEST_CASE("PolicyAllocator Multithreaded Test", "[Memory]")
+{
+	SharedAllocator allocator("Shared Allocator");
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++)
+	{
+		threads.emplace_back([&allocator] {
+			for (int i = 0; i < 1000; i++)
+			{
+				allocator.Deallocate(allocator.Allocate(64), 64);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	REQUIRE(allocator.GetAllocatorData().UsedSize == 0);
+	REQUIRE(allocator.GetOverrunCount() == 0);
+}
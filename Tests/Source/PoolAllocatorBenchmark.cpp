@@ -0,0 +1,143 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+namespace
+{
+	constexpr int s_NumOperations = 20000;
+	constexpr int s_NumLiveObjects = 64;
+
+	// A single threaded pool behind one lock, which is what sharing a pool took before
+	class LockedPoolAllocator
+	{
+	  public:
+		LockedPoolAllocator(const char* debugName, const Size blockSize)
+			: m_Pool(debugName, blockSize)
+		{
+		}
+
+		void* Allocate()
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_Pool.Allocate();
+		}
+
+		void Deallocate(TestObject* ptr)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Pool.Deallocate(ptr);
+		}
+
+	  private:
+		PoolAllocator<TestObject, ResizePolicy::Resizable> m_Pool;
+		std::mutex m_Mutex;
+	};
+
+	using LockFreePoolAllocator = PoolAllocator<TestObject, ResizePolicy::Resizable, ThreadingPolicy::MultiThreaded>;
+
+	// Every thread keeps a window of live objects and replaces one of them per operation
+	template <typename Allocator>
+	void Churn(Allocator& allocator, const int thread)
+	{
+		TestObject* ptrs[s_NumLiveObjects];
+		for (int i = 0; i < s_NumLiveObjects; i++)
+		{
+			ptrs[i] = (TestObject*)allocator.Allocate();
+		}
+
+		for (int i = 0; i < s_NumOperations; i++)
+		{
+			const int slot = (i * 7 + thread) % s_NumLiveObjects;
+			allocator.Deallocate(ptrs[slot]);
+			ptrs[slot] = (TestObject*)allocator.Allocate();
+		}
+
+		for (int i = 0; i < s_NumLiveObjects; i++)
+		{
+			allocator.Deallocate(ptrs[i]);
+		}
+	}
+
+	template <typename Allocator>
+	void BenchmarkThreads(Catch::Benchmark::Chronometer& meter, const int numThreads)
+	{
+		Allocator allocator("Benchmark Allocator", 4096);
+
+		meter.measure([&] {
+			std::vector<std::thread> threads;
+			for (int t = 0; t < numThreads; t++)
+			{
+				threads.emplace_back([&allocator, t] { Churn(allocator, t); });
+			}
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		});
+	}
+} // namespace
+
+// Every thread does the same amount of work, so flat timings mean linear scaling
+TEST_CASE("PoolAllocator Contention Benchmark", "[Memory][!benchmark]")
+{
+	const bool logCore = Logger::s_LogCoreOn;
+	Logger::s_LogCoreOn = false;
+
+	for (int numThreads : {1, 2, 4, 8})
+	{
+		const std::string threads = std::to_string(numThreads) + (numThreads == 1 ? " Thread" : " Threads");
+
+		BENCHMARK_ADVANCED("Locked, " + threads)(Catch::Benchmark::Chronometer meter)
+		{
+			BenchmarkThreads<LockedPoolAllocator>(meter, numThreads);
+		};
+
+		BENCHMARK_ADVANCED("Lock-Free, " + threads)(Catch::Benchmark::Chronometer meter)
+		{
+			BenchmarkThreads<LockFreePoolAllocator>(meter, numThreads);
+		};
+	}
+
+	Logger::s_LogCoreOn = logCore;
+}
+
+// Spawning and clearing a level worth of objects
+TEST_CASE("PoolAllocator Batch Benchmark", "[Memory][!benchmark]")
+{
+	constexpr Size numObjects = 10000;
+
+	const bool logCore = Logger::s_LogCoreOn;
+	Logger::s_LogCoreOn = false;
+
+	PoolAllocator<TestObject, ResizePolicy::Resizable> poolAllocator("Benchmark Allocator", numObjects);
+	std::vector<TestObject*> objectPtrs(numObjects);
+
+	BENCHMARK_ADVANCED("New and Delete")(Catch::Benchmark::Chronometer meter)
+	{
+		meter.measure([&] {
+			for (Size i = 0; i < numObjects; i++)
+			{
+				objectPtrs[i] = poolAllocator.New(1, 2.1f, 'a', true, 10.6f);
+			}
+			for (Size i = 0; i < numObjects; i++)
+			{
+				poolAllocator.Delete(objectPtrs[i]);
+			}
+		});
+	};
+
+	BENCHMARK_ADVANCED("NewN and DeleteN")(Catch::Benchmark::Chronometer meter)
+	{
+		meter.measure([&] {
+			poolAllocator.NewN(objectPtrs.data(), numObjects, 1, 2.1f, 'a', true, 10.6f);
+			poolAllocator.DeleteN(objectPtrs.data(), numObjects);
+		});
+	};
+
+	Logger::s_LogCoreOn = logCore;
+}
@@ -179,3 +179,134 @@ TEST_CASE("PoolAllocator Reallocation Test", "[Memory]")
 		REQUIRE(objectPtrs2[i]->e == 10.6f + (2 * i));
 	}
 }
+
+TEST_CASE("PoolAllocator Chunk Reuse Test", "[Memory]")
+{
+	PoolAllocator<TestObject> poolAllocator = PoolAllocator<TestObject>("Allocator", 3);
+
+	// Fresh chunks are handed out in order
+	TestObject* first = poolAllocator.New(1, 2.1f, 'a', true, 10.6f);
+	TestObject* second = poolAllocator.New(2, 2.1f, 'b', true, 10.6f);
+	TestObject* third = poolAllocator.New(3, 2.1f, 'c', true, 10.6f);
+
+	REQUIRE((Size)second == (Size)first + sizeof(TestObject));
+	REQUIRE((Size)third == (Size)second + sizeof(TestObject));
+
+	SECTION("Full Pool")
+	{
+		REQUIRE(poolAllocator.Allocate() == nullptr);
+		REQUIRE(poolAllocator.GetUsedSize() == 3 * sizeof(TestObject));
+	}
+
+	SECTION("Freed Chunks")
+	{
+		poolAllocator.Delete(second);
+		poolAllocator.Delete(first);
+
+		// The most recently freed chunk comes back first
+		REQUIRE(poolAllocator.New(4, 2.1f, 'd', true, 10.6f) == first);
+		REQUIRE(poolAllocator.New(5, 2.1f, 'e', true, 10.6f) == second);
+		REQUIRE(poolAllocator.Allocate() == nullptr);
+
+		REQUIRE(first->a == 4);
+		REQUIRE(second->a == 5);
+		REQUIRE(third->a == 3);
+	}
+}
+
+struct alignas(32) AlignedTestObject
+{
+	float values[8];
+
+	AlignedTestObject(float value) { std::fill(std::begin(values), std::end(values), value); }
+};
+
+TEST_CASE("PoolAllocator Alignment Test", "[Memory]")
+{
+	SECTION("Object Alignment")
+	{
+		PoolAllocator<AlignedTestObject> poolAllocator{"Allocator", 16};
+		for (int i = 0; i < 16; i++)
+		{
+			REQUIRE((Size)poolAllocator.New(1.0f * i) % alignof(AlignedTestObject) == 0);
+		}
+	}
+
+	SECTION("Explicit Alignment")
+	{
+		PoolAllocator<TestObject, ResizePolicy::Fixed, ThreadingPolicy::SingleThreaded, 16> poolAllocator{"Allocator", 16};
+		REQUIRE(poolAllocator.GetChunkSize() == Utility::AlignForward(sizeof(TestObject), 16));
+
+		for (int i = 0; i < 16; i++)
+		{
+			TestObject* object = poolAllocator.New(i, 2.1f + i, 'a' + i, i % 2, 10.6f + (2 * i));
+			REQUIRE((Size)object % 16 == 0);
+			REQUIRE(object->a == i);
+		}
+		REQUIRE(poolAllocator.GetUsedSize() == 16 * poolAllocator.GetChunkSize());
+	}
+
+	SECTION("Cache Line Padding")
+	{
+		const Size cacheLineSize = GetCacheLineSize() != 0 ? GetCacheLineSize() : 64;
+
+		PoolAllocator<TestObject> poolAllocator{"Allocator", 16, 0, PaddingPolicy::CacheLine};
+		REQUIRE(poolAllocator.GetChunkSize() == cacheLineSize);
+
+		std::vector<TestObject*> objectPtrs = std::vector<TestObject*>();
+		for (int i = 0; i < 16; i++)
+		{
+			objectPtrs.push_back(poolAllocator.New(i, 2.1f + i, 'a' + i, i % 2, 10.6f + (2 * i)));
+			REQUIRE((Size)objectPtrs.back() % cacheLineSize == 0);
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			REQUIRE(objectPtrs[i]->a == i);
+		}
+	}
+}
+
+TEST_CASE("PoolAllocator Batch Test", "[Memory]")
+{
+	PoolAllocator<TestObject, ResizePolicy::Resizable> poolAllocator{"Allocator", 16, 64};
+	std::vector<TestObject*> objectPtrs(100);
+
+	// Spans several blocks
+	REQUIRE(poolAllocator.NewN(objectPtrs.data(), 100, 1, 2.1f, 'a', true, 10.6f) == 100);
+	REQUIRE(poolAllocator.GetUsedSize() == 100 * sizeof(TestObject));
+
+	std::sort(objectPtrs.begin(), objectPtrs.end());
+	REQUIRE(std::adjacent_find(objectPtrs.begin(), objectPtrs.end()) == objectPtrs.end());
+	for (TestObject* object : objectPtrs)
+	{
+		REQUIRE(object->a == 1);
+	}
+
+	poolAllocator.DeleteN(objectPtrs.data(), 50);
+	REQUIRE(poolAllocator.GetUsedSize() == 50 * sizeof(TestObject));
+
+	// The freed chunks are reused first
+	std::vector<TestObject*> newObjectPtrs(50);
+	REQUIRE(poolAllocator.AllocateN(newObjectPtrs.data(), 50) == 50);
+	REQUIRE(std::is_permutation(newObjectPtrs.begin(), newObjectPtrs.end(), objectPtrs.begin()));
+
+	poolAllocator.DeallocateN(newObjectPtrs.data(), 50);
+	poolAllocator.DeleteN(objectPtrs.data() + 50, 50);
+	REQUIRE(poolAllocator.GetUsedSize() == 0);
+
+	const Size blockCount = poolAllocator.GetBlockCount();
+	REQUIRE(poolAllocator.ReleaseEmptyBlocks() == blockCount);
+}
+
+TEST_CASE("Fixed PoolAllocator Batch Out Of Memory Test", "[Memory]")
+{
+	PoolAllocator<TestObject> poolAllocator{"Allocator", 16};
+	std::vector<TestObject*> objectPtrs(20);
+
+	REQUIRE(poolAllocator.AllocateN(objectPtrs.data(), 20) == 16);
+	REQUIRE(poolAllocator.GetUsedSize() == 16 * sizeof(TestObject));
+
+	poolAllocator.DeallocateN(objectPtrs.data(), 16);
+	REQUIRE(poolAllocator.GetUsedSize() == 0);
+}
@@ -205,3 +205,87 @@ TEST_CASE("ResizablePoolAllocator Reallocation Test", "[Memory]")
 		REQUIRE(objectPtrs2[i]->e == 10.6f + (2 * i));
 	}
 }
+
+TEST_CASE("ResizablePoolAllocator Growth Test", "[Memory]")
+{
+	PoolAllocator<TestObject, ResizePolicy::Resizable> poolAllocator{"Allocator", 4, 16};
+	const AllocatorData& data = poolAllocator.GetAllocatorData();
+
+	// Blocks of 4, 8, 16 and then 16 items again
+	for (int i = 0; i < 4 + 8 + 16 + 16; i++)
+	{
+		poolAllocator.New(i, 2.1f + i, 'a' + i, i % 2, 10.6f + (2 * i));
+	}
+
+	REQUIRE(poolAllocator.GetBlockCount() == 4);
+	REQUIRE(poolAllocator.GetTotalSize() == (4 + 8 + 16 + 16) * sizeof(TestObject));
+
+	Size chunkCount = 0;
+	for (const AllocatorData::PoolBlock& block : data.PoolBlocks)
+	{
+		REQUIRE(block.UsedChunks == block.ChunkCount);
+		chunkCount += block.ChunkCount;
+	}
+	REQUIRE(chunkCount == 4 + 8 + 16 + 16);
+}
+
+TEST_CASE("ResizablePoolAllocator Empty Block Release Test", "[Memory]")
+{
+	PoolAllocator<TestObject, ResizePolicy::Resizable> poolAllocator{"Allocator", 4, 16};
+	const AllocatorData& data = poolAllocator.GetAllocatorData();
+	std::vector<TestObject*> objectPtrs = std::vector<TestObject*>();
+
+	// The first 4 items fill the first block, the next 8 the second one
+	for (int i = 0; i < 12; i++)
+	{
+		objectPtrs.push_back(poolAllocator.New(i, 2.1f + i, 'a' + i, i % 2, 10.6f + (2 * i)));
+	}
+
+	SECTION("No Empty Blocks")
+	{
+		poolAllocator.Delete(objectPtrs[11]);
+		REQUIRE(poolAllocator.ReleaseEmptyBlocks() == 0);
+		REQUIRE(poolAllocator.GetBlockCount() == 2);
+	}
+
+	SECTION("Empty Block")
+	{
+		for (int i = 4; i < 12; i++)
+		{
+			poolAllocator.Delete(objectPtrs[i]);
+		}
+		// A chunk of the block that stays must stay in the free list
+		poolAllocator.Delete(objectPtrs[0]);
+
+		REQUIRE(poolAllocator.ReleaseEmptyBlocks() == 1);
+		REQUIRE(poolAllocator.GetBlockCount() == 1);
+		REQUIRE(poolAllocator.GetTotalSize() == 4 * sizeof(TestObject));
+		REQUIRE(data.PoolBlocks[0].UsedChunks == 3);
+
+		REQUIRE(poolAllocator.New(0, 2.1f, 'a', false, 10.6f) == objectPtrs[0]);
+		for (int i = 1; i < 4; i++)
+		{
+			REQUIRE(objectPtrs[i]->a == i);
+		}
+
+		// The pool keeps growing where it left off
+		poolAllocator.New(12, 2.1f, 'a', false, 10.6f);
+		REQUIRE(poolAllocator.GetBlockCount() == 2);
+		REQUIRE(poolAllocator.GetTotalSize() == (4 + 16) * sizeof(TestObject));
+	}
+
+	SECTION("All Blocks")
+	{
+		for (TestObject* object : objectPtrs)
+		{
+			poolAllocator.Delete(object);
+		}
+
+		REQUIRE(poolAllocator.ReleaseEmptyBlocks() == 2);
+		REQUIRE(poolAllocator.GetBlockCount() == 0);
+		REQUIRE(poolAllocator.GetTotalSize() == 0);
+
+		REQUIRE(poolAllocator.New(0, 2.1f, 'a', false, 10.6f)->a == 0);
+		REQUIRE(poolAllocator.GetBlockCount() == 1);
+	}
+}
@@ -19,3 +19,133 @@ using namespace QMBT;
 // 		REQUIRE(vec[i] == i);
 // 	}
 // }
+
+namespace
+{
+	// Serves a vector from its own FreeListAllocator, so nothing else can take the memory after its buffer
+	class TestVectorAllocator
+	{
+	  public:
+		TestVectorAllocator(FreeListAllocator* heap = nullptr)
+			: m_Heap(heap) {}
+
+		void* allocate(size_t numBytes, int flags = 0) { return m_Heap->Allocate(numBytes); }
+		void* allocate(size_t numBytes, size_t alignment, size_t offset, int flags = 0) { return m_Heap->Allocate(numBytes, alignment); }
+		void deallocate(void* ptr, size_t numBytes) { m_Heap->Deallocate(ptr); }
+		bool try_expand(void* ptr, size_t numBytes, size_t newNumBytes) { return m_Heap->TryExpand(ptr, newNumBytes); }
+
+	  private:
+		FreeListAllocator* m_Heap;
+	};
+} // namespace
+
+TEST_CASE("Vector In Place Growth Test", "[Memory]")
+{
+	FreeListAllocator freeListAllocator = FreeListAllocator("FreeList Allocator", 1_MB);
+
+	Vector<int, TestVectorAllocator> vec = Vector<int, TestVectorAllocator>(TestVectorAllocator(&freeListAllocator));
+	vec.push_back(0);
+	const int* data = vec.data();
+
+	for (int i = 1; i < 10000; i++)
+	{
+		vec.push_back(i);
+	}
+
+	// Nothing else is allocated after the buffer, so it never has to move
+	REQUIRE(vec.data() == data);
+	REQUIRE(vec.size() == 10000);
+	for (int i = 0; i < 10000; i++)
+	{
+		REQUIRE(vec[i] == i);
+	}
+
+	SECTION("Blocked Growth")
+	{
+		void* blocker = freeListAllocator.Allocate(16);
+		vec.resize(vec.capacity() + 1);
+
+		REQUIRE(vec.data() != data);
+		REQUIRE(vec[9999] == 9999);
+
+		freeListAllocator.Deallocate(blocker);
+	}
+}
+
+TEST_CASE("STLAllocator Memory Resource Test", "[Memory]")
+{
+	SECTION("Frame Allocator")
+	{
+		FrameAllocator frameAllocator("Frame Allocator", 1_MB);
+		AllocatorResource<FrameAllocator> resource(frameAllocator);
+
+		{
+			Vector<int> vec(STLAllocator("Frame Vector", &resource));
+			for (int i = 0; i < 1000; i++)
+			{
+				vec.push_back(i);
+			}
+
+			String name("A name that does not fit in the inline buffer", STLAllocator("Frame String", &resource));
+
+			REQUIRE(vec[999] == 999);
+			REQUIRE(frameAllocator.GetUsedSize() >= 1000 * sizeof(int) + name.size());
+		}
+
+		// Freeing the containers cost nothing, the memory comes back at the end of the frame
+		REQUIRE(frameAllocator.GetUsedSize() > 0);
+		frameAllocator.EndFrame();
+		REQUIRE(frameAllocator.GetUsedSize() == 0);
+	}
+
+	SECTION("Free List Allocator")
+	{
+		FreeListAllocator freeListAllocator("FreeList Allocator", 1_MB);
+		AllocatorResource<FreeListAllocator> resource(freeListAllocator);
+
+		{
+			Vector<int> vec(STLAllocator("Free List Vector", &resource));
+			for (int i = 0; i < 1000; i++)
+			{
+				vec.push_back(i);
+			}
+			REQUIRE(freeListAllocator.GetUsedSize() >= 1000 * sizeof(int));
+		}
+
+		REQUIRE(freeListAllocator.GetUsedSize() == 0);
+	}
+
+	SECTION("Pool Allocator")
+	{
+		struct Node
+		{
+			void* links[3];
+		};
+		PoolAllocator<Node, ResizePolicy::Resizable> poolAllocator("Pool Allocator", 16);
+		AllocatorResource<PoolAllocator<Node, ResizePolicy::Resizable>> resource(poolAllocator);
+
+		// Every node of a node based container fits in a chunk
+		std::vector<void*> nodes;
+		for (int i = 0; i < 100; i++)
+		{
+			nodes.push_back(resource.Allocate(sizeof(int) + 2 * sizeof(void*), alignof(void*), AllocationTag()));
+		}
+		REQUIRE(poolAllocator.GetUsedSize() == 100 * poolAllocator.GetChunkSize());
+
+		for (void* node : nodes)
+		{
+			resource.Deallocate(node, sizeof(int) + 2 * sizeof(void*), AllocationTag());
+		}
+		REQUIRE(poolAllocator.GetUsedSize() == 0);
+	}
+
+	SECTION("Equality")
+	{
+		FrameAllocator frameAllocator("Frame Allocator", 1_MB);
+		AllocatorResource<FrameAllocator> resource(frameAllocator);
+
+		REQUIRE(STLAllocator("Rows", &resource) == STLAllocator("Rows", &resource));
+		REQUIRE(STLAllocator("Rows", &resource) != STLAllocator("Rows"));
+		REQUIRE(STLAllocator("Rows") != STLAllocator("Columns"));
+	}
+}
@@ -0,0 +1,68 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+TEST_CASE("ScratchArena Scope Test", "[Memory]")
+{
+	StackAllocator& threadAllocator = ScratchArena::GetThreadAllocator();
+	const Size usedSize = threadAllocator.GetUsedSize();
+
+	{
+		ScratchArena outer;
+		TestObject* object = outer.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+		const Size outerSize = threadAllocator.GetUsedSize();
+		{
+			ScratchArena inner;
+			memset(inner.Allocate(1_KB), 1, 1_KB);
+		}
+		REQUIRE(threadAllocator.GetUsedSize() == outerSize);
+		REQUIRE(object->a == 1);
+	}
+
+	REQUIRE(threadAllocator.GetUsedSize() == usedSize);
+	REQUIRE(threadAllocator.GetAllocatorData().PeakUsedSize >= 1_KB);
+}
+
+TEST_CASE("ScratchArena Multithreaded Test", "[Memory]")
+{
+	constexpr int numThreads = 4;
+
+	// Every thread gets its own arena, so nested scopes on different threads never free each other's memory
+	std::atomic<bool> intact = true;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; t++)
+	{
+		threads.emplace_back([&, t] {
+			StackAllocator& threadAllocator = ScratchArena::GetThreadAllocator();
+
+			for (int i = 0; i < 1000; i++)
+			{
+				ScratchArena scratch;
+				int* values = (int*)scratch.Allocate(64 * sizeof(int));
+				for (int j = 0; j < 64; j++)
+				{
+					values[j] = t;
+				}
+				if (values[63] != t || threadAllocator.GetUsedSize() == 0)
+				{
+					intact = false;
+				}
+			}
+
+			if (threadAllocator.GetUsedSize() != 0)
+			{
+				intact = false;
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	REQUIRE(intact);
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <Qombat/Tests.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+namespace
+{
+	constexpr int s_NumObjects = 100000;
+} // namespace
+
+// Walking every live object once the pool has been churned for a while, so neighbours in the pointer list
+// are far apart in memory
+TEST_CASE("SlotMap Iteration Benchmark", "[Types][!benchmark]")
+{
+	const bool logCore = Logger::s_LogCoreOn;
+	const bool logMemory = Logger::s_LogMemoryOn;
+	Logger::s_LogCoreOn = false;
+	Logger::s_LogMemoryOn = false;
+
+	std::mt19937 random(42);
+
+	PoolAllocator<TestObject, ResizePolicy::Resizable> poolAllocator("Benchmark Allocator", 4096);
+	std::vector<TestObject*> objectPtrs;
+	for (int i = 0; i < 2 * s_NumObjects; i++)
+	{
+		objectPtrs.push_back(poolAllocator.New(i, 1.0f, 'a', false, 2.0f));
+	}
+	std::shuffle(objectPtrs.begin(), objectPtrs.end(), random);
+	for (int i = s_NumObjects; i < 2 * s_NumObjects; i++)
+	{
+		poolAllocator.Delete(objectPtrs[i]);
+	}
+	objectPtrs.resize(s_NumObjects);
+
+	SlotMap<TestObject> slotMap("Benchmark Slot Map");
+	std::vector<SlotHandle> handles;
+	for (int i = 0; i < 2 * s_NumObjects; i++)
+	{
+		handles.push_back(slotMap.Emplace(i, 1.0f, 'a', false, 2.0f));
+	}
+	std::shuffle(handles.begin(), handles.end(), random);
+	for (int i = s_NumObjects; i < 2 * s_NumObjects; i++)
+	{
+		slotMap.Remove(handles[i]);
+	}
+	handles.resize(s_NumObjects);
+
+	BENCHMARK("Pool Pointers")
+	{
+		float sum = 0.0f;
+		for (TestObject* object : objectPtrs)
+		{
+			sum += object->b * object->e;
+		}
+		return sum;
+	};
+
+	BENCHMARK("Slot Map Handles")
+	{
+		float sum = 0.0f;
+		for (SlotHandle handle : handles)
+		{
+			const TestObject* object = slotMap.Get(handle);
+			sum += object->b * object->e;
+		}
+		return sum;
+	};
+
+	BENCHMARK("Slot Map Packed")
+	{
+		float sum = 0.0f;
+		for (const TestObject& object : slotMap)
+		{
+			sum += object.b * object.e;
+		}
+		return sum;
+	};
+
+	for (TestObject* object : objectPtrs)
+	{
+		poolAllocator.Delete(object);
+	}
+
+	Logger::s_LogCoreOn = logCore;
+	Logger::s_LogMemoryOn = logMemory;
+}
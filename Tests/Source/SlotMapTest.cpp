@@ -0,0 +1,120 @@
+#include <vector>
+
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+TEST_CASE("SlotMap Insertion Test", "[Types]")
+{
+	SlotMap<TestObject> slotMap("Slot Map");
+	std::vector<SlotHandle> handles;
+
+	for (int i = 0; i < 100; i++)
+	{
+		handles.push_back(slotMap.Emplace(i, 2.1f + i, 'a' + i, i % 2, 10.6f + (2 * i)));
+	}
+
+	REQUIRE(slotMap.GetSize() == 100);
+	REQUIRE(!SlotHandle().IsValid());
+
+	for (int i = 0; i < 100; i++)
+	{
+		REQUIRE(handles[i].IsValid());
+		REQUIRE(slotMap.Contains(handles[i]));
+		REQUIRE(slotMap.Get(handles[i])->a == i);
+		REQUIRE(slotMap.Get(handles[i])->e == 10.6f + (2 * i));
+
+		// The objects are packed in insertion order until one is removed
+		REQUIRE(slotMap[i].a == i);
+		REQUIRE(slotMap.GetHandle(i) == handles[i]);
+	}
+
+	REQUIRE(slotMap.Get(SlotHandle()) == nullptr);
+}
+
+TEST_CASE("SlotMap Removal Test", "[Types]")
+{
+	SlotMap<TestObject> slotMap("Slot Map");
+	std::vector<SlotHandle> handles;
+
+	for (int i = 0; i < 100; i++)
+	{
+		handles.push_back(slotMap.Emplace(i, 2.1f + i, 'a' + i, i % 2, 10.6f + (2 * i)));
+	}
+
+	for (int i = 0; i < 100; i += 2)
+	{
+		REQUIRE(slotMap.Remove(handles[i]));
+	}
+
+	REQUIRE(slotMap.GetSize() == 50);
+
+	for (int i = 0; i < 100; i++)
+	{
+		if (i % 2 == 0)
+		{
+			// Stale handles are told apart from live ones
+			REQUIRE(!slotMap.Contains(handles[i]));
+			REQUIRE(slotMap.Get(handles[i]) == nullptr);
+			REQUIRE(!slotMap.Remove(handles[i]));
+		}
+		else
+		{
+			REQUIRE(slotMap.Get(handles[i])->a == i);
+		}
+	}
+
+	// The objects stay packed, and every one of them knows its handle
+	int count = 0;
+	for (TestObject& object : slotMap)
+	{
+		REQUIRE(object.a % 2 == 1);
+		REQUIRE(slotMap.GetHandle(count) == handles[object.a]);
+		count++;
+	}
+	REQUIRE(count == 50);
+
+	SECTION("Slot Reuse")
+	{
+		// A reused slot gets a new generation, so the old handle stays stale
+		SlotHandle handle = slotMap.Emplace(100, 2.1f, 'a', false, 10.6f);
+		REQUIRE(handle.GetIndex() == handles[98].GetIndex());
+		REQUIRE(handle != handles[98]);
+		REQUIRE(slotMap.Get(handles[98]) == nullptr);
+		REQUIRE(slotMap.Get(handle)->a == 100);
+	}
+
+	SECTION("Clear")
+	{
+		slotMap.Clear();
+
+		REQUIRE(slotMap.IsEmpty());
+		for (SlotHandle handle : handles)
+		{
+			REQUIRE(!slotMap.Contains(handle));
+		}
+	}
+}
+
+TEST_CASE("SlotMap Generation Overflow Test", "[Types]")
+{
+	SlotMap<int> slotMap("Slot Map");
+
+	SlotHandle first = slotMap.Insert(0);
+	SlotHandle handle = first;
+	for (UInt32 i = 0; i < SlotHandle::MAX_GENERATION; i++)
+	{
+		REQUIRE(slotMap.Remove(handle));
+		handle = slotMap.Insert(0);
+		REQUIRE(handle.GetIndex() == first.GetIndex());
+	}
+	REQUIRE(handle.GetGeneration() == SlotHandle::MAX_GENERATION);
+
+	// The slot has run out of generations, so it is retired instead of wrapping around to the first handle
+	REQUIRE(slotMap.Remove(handle));
+	REQUIRE(slotMap.Insert(0).GetIndex() != first.GetIndex());
+	REQUIRE(!slotMap.Contains(first));
+}
@@ -0,0 +1,98 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+namespace
+{
+	constexpr int s_NumEntries = 2000;
+
+	// An EASTL allocator that sends everything to one engine allocator, so the same containers can be timed
+	// on top of either path
+	template <typename Backend>
+	class BenchmarkSTLAllocator
+	{
+	  public:
+		BenchmarkSTLAllocator(const char* debugName = "Benchmark STL Allocator") {}
+
+		void* allocate(size_t numBytes, int flags = 0) { return s_Backend->Allocate(numBytes, 8); }
+		void* allocate(size_t numBytes, size_t alignment, size_t offset, int flags = 0) { return s_Backend->Allocate(numBytes, alignment); }
+		void deallocate(void* ptr, size_t numBytes) { s_Backend->Deallocate(ptr, numBytes); }
+
+		static inline Backend* s_Backend = nullptr;
+	};
+
+	template <typename Backend>
+	bool operator==(const BenchmarkSTLAllocator<Backend>& a, const BenchmarkSTLAllocator<Backend>& b)
+	{
+		return true;
+	}
+	template <typename Backend>
+	bool operator!=(const BenchmarkSTLAllocator<Backend>& a, const BenchmarkSTLAllocator<Backend>& b)
+	{
+		return false;
+	}
+
+	// Hash map nodes, strings too long for their inline buffer, short vectors and shared pointer control
+	// blocks, which are what most engine containers allocate
+	template <typename Backend>
+	float BuildContainers()
+	{
+		using Allocator = BenchmarkSTLAllocator<Backend>;
+		using BenchmarkString = eastl::basic_string<char, Allocator>;
+		using BenchmarkVector = eastl::vector<int, Allocator>;
+
+		eastl::unordered_map<int, BenchmarkString, eastl::hash<int>, eastl::equal_to<int>, Allocator> names;
+		eastl::vector<BenchmarkVector, Allocator> lists;
+		eastl::vector<eastl::shared_ptr<TestObject>, Allocator> objects;
+
+		for (int i = 0; i < s_NumEntries; i++)
+		{
+			names[i] = BenchmarkString("A name that does not fit in the inline buffer");
+
+			BenchmarkVector& list = lists.emplace_back();
+			for (int j = 0; j < i % 16; j++)
+			{
+				list.push_back(j);
+			}
+
+			objects.push_back(eastl::allocate_shared<TestObject>(Allocator(), i, 1.0f, 'a', false, 2.0f));
+		}
+
+		float sum = 0.0f;
+		for (const auto& object : objects)
+		{
+			sum += object->b;
+		}
+		return sum + names.size() + lists.size();
+	}
+} // namespace
+
+TEST_CASE("SmallObjectAllocator Container Benchmark", "[Memory][!benchmark]")
+{
+	const bool logMemory = Logger::s_LogMemoryOn;
+	Logger::s_LogMemoryOn = false;
+
+	// What STLAllocator used before, every block comes from the thread cached free list
+	ThreadCachedAllocator globalHeap("Benchmark Global Heap", 64_MB);
+	BenchmarkSTLAllocator<ThreadCachedAllocator>::s_Backend = &globalHeap;
+
+	ThreadCachedAllocator smallObjectHeap("Benchmark Small Object Heap", 64_MB);
+	SmallObjectAllocator smallObjectAllocator(&smallObjectHeap);
+	BenchmarkSTLAllocator<SmallObjectAllocator>::s_Backend = &smallObjectAllocator;
+
+	BENCHMARK("Free List")
+	{
+		return BuildContainers<ThreadCachedAllocator>();
+	};
+
+	BENCHMARK("Small Object Pools")
+	{
+		return BuildContainers<SmallObjectAllocator>();
+	};
+
+	Logger::s_LogMemoryOn = logMemory;
+}
@@ -0,0 +1,195 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+TEST_CASE("SmallObjectAllocator Allocation Test", "[Memory]")
+{
+	ThreadCachedAllocator heap = ThreadCachedAllocator("Heap", 10_MB);
+	SmallObjectAllocator allocator(&heap);
+
+	SECTION("Size Classes")
+	{
+		// Small blocks come from the pools, rounded up to their size class, and never touch the heap
+		std::vector<void*> ptrs;
+		Size classSizes = 0;
+		for (Size size = 1; size <= SmallObjectAllocator::MAX_SMALL_SIZE; size++)
+		{
+			void* ptr = allocator.Allocate(size);
+			REQUIRE((Size)ptr % SmallObjectAllocator::SMALL_ALIGNMENT == 0);
+			memset(ptr, 0xAB, size);
+
+			ptrs.push_back(ptr);
+			classSizes += (SmallObjectAllocator::GetSizeClass(size) + 1) * SmallObjectAllocator::SIZE_CLASS_GRANULARITY;
+		}
+
+		REQUIRE(allocator.GetUsedSize() == classSizes);
+		REQUIRE(heap.GetUsedSize() == 0);
+
+		for (Size size = 1; size <= SmallObjectAllocator::MAX_SMALL_SIZE; size++)
+		{
+			allocator.Deallocate(ptrs[size - 1], size);
+		}
+		REQUIRE(allocator.GetUsedSize() == 0);
+	}
+
+	SECTION("Large Blocks")
+	{
+		void* ptr = allocator.Allocate(SmallObjectAllocator::MAX_SMALL_SIZE + 1);
+
+		REQUIRE(allocator.GetUsedSize() == 0);
+		REQUIRE(heap.GetUsedSize() > SmallObjectAllocator::MAX_SMALL_SIZE);
+
+		allocator.Deallocate(ptr, SmallObjectAllocator::MAX_SMALL_SIZE + 1);
+	}
+
+	SECTION("Alignment")
+	{
+		// A block that is a multiple of its alignment in size lands in a size class aligned to it
+		for (Size alignment = 8; alignment <= 256; alignment *= 2)
+		{
+			for (Size size = alignment; size <= SmallObjectAllocator::MAX_SMALL_SIZE; size += alignment)
+			{
+				void* ptr = allocator.Allocate(size, alignment);
+				REQUIRE((Size)ptr % alignment == 0);
+				allocator.Deallocate(ptr, size);
+			}
+		}
+	}
+
+	SECTION("Reuse")
+	{
+		// A freed chunk goes back to the pool of its size class
+		void* ptr = allocator.Allocate(40);
+		allocator.Deallocate(ptr, 40);
+
+		void* reusedPtr = allocator.Allocate(48);
+		REQUIRE(reusedPtr == ptr);
+
+		allocator.Deallocate(reusedPtr, 48);
+	}
+
+	SECTION("Resize")
+	{
+		// Small blocks resize within their size class, large ones through the heap
+		void* small = allocator.Allocate(40);
+		REQUIRE(allocator.TryExpand(small, 40, 48));
+		REQUIRE_FALSE(allocator.TryExpand(small, 48, 64));
+		REQUIRE_FALSE(allocator.TryExpand(small, 48, 2048));
+
+		memset(small, 3, 48);
+		UInt8* large = (UInt8*)allocator.Reallocate(small, 48, 2048);
+		REQUIRE(large[47] == 3);
+		REQUIRE(allocator.GetUsedSize() == 0);
+
+		UInt8* shrunk = (UInt8*)allocator.Reallocate(large, 2048, 100);
+		REQUIRE(shrunk[47] == 3);
+		REQUIRE(allocator.GetUsedSize() == 112);
+
+		allocator.Deallocate(shrunk, 100);
+	}
+
+	SECTION("Tags")
+	{
+		AllocationTag tag("Small Objects");
+
+		void* ptr = allocator.Allocate(20, 8, tag);
+		REQUIRE(allocator.GetPoolAllocatorData(1).TaggedSizes[tag.GetID()] == 32);
+
+		allocator.Deallocate(ptr, 20, tag);
+		REQUIRE(allocator.GetPoolAllocatorData(1).TaggedSizes[tag.GetID()] == 0);
+	}
+
+	REQUIRE(allocator.GetUsedSize() == 0);
+	heap.FlushThreadCache();
+	REQUIRE(heap.GetUsedSize() == 0);
+}
+
+TEST_CASE("SmallObjectAllocator Multithreaded Test", "[Memory]")
+{
+	ThreadCachedAllocator heap = ThreadCachedAllocator("Heap", 10_MB);
+	SmallObjectAllocator allocator(&heap);
+
+	constexpr int numThreads = 4;
+	constexpr int numAllocations = 2000;
+
+	// Every thread frees the blocks the previous one allocated
+	std::vector<std::vector<TestObject*>> objectPtrs(numThreads);
+	for (int t = 0; t < numThreads; t++)
+	{
+		for (int i = 0; i < numAllocations; i++)
+		{
+			objectPtrs[t].push_back(new (allocator.Allocate(sizeof(TestObject))) TestObject(i, 1.0f, 'a', false, 2.0f));
+		}
+	}
+
+	std::atomic<bool> intact = true;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; t++)
+	{
+		threads.emplace_back([&, t] {
+			for (TestObject* object : objectPtrs[(t + 1) % numThreads])
+			{
+				if (object->e != 2.0f)
+				{
+					intact = false;
+				}
+				allocator.Deallocate(object, sizeof(TestObject));
+			}
+
+			for (int i = 0; i < numAllocations; i++)
+			{
+				allocator.Deallocate(allocator.Allocate(24 + i % 200), 24 + i % 200);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	REQUIRE(intact);
+	REQUIRE(allocator.GetUsedSize() == 0);
+}
+
+TEST_CASE("SmallObjectAllocator Global Allocator Logging Test", "[Memory]")
+{
+	// The global allocators are built and used before main initializes the loggers, so nothing on their
+	// allocation and block growth paths may log
+	std::shared_ptr<spdlog::logger> coreLogger = std::exchange(Logger::GetCoreLogger(), nullptr);
+	std::shared_ptr<spdlog::logger> memoryLogger = std::exchange(Logger::GetMemoryLogger(), nullptr);
+
+	{
+		SmallObjectAllocator allocator(GetGlobalAllocator());
+
+		// Enough blocks of every size class that each pool has to add a few
+		std::vector<std::pair<void*, Size>> ptrs;
+		for (Size size = SmallObjectAllocator::SIZE_CLASS_GRANULARITY; size <= SmallObjectAllocator::MAX_SMALL_SIZE;
+			 size += SmallObjectAllocator::SIZE_CLASS_GRANULARITY)
+		{
+			for (int i = 0; i < 1000; i++)
+			{
+				ptrs.push_back({allocator.Allocate(size), size});
+			}
+		}
+		for (auto& [ptr, size] : ptrs)
+		{
+			allocator.Deallocate(ptr, size);
+		}
+
+		// And the containers on the global small object allocator
+		Vector<int> vec;
+		for (int i = 0; i < 1000; i++)
+		{
+			vec.push_back(i);
+		}
+		String name("A name that does not fit in the inline buffer");
+		REQUIRE(vec[999] == 999);
+	}
+
+	Logger::GetCoreLogger() = coreLogger;
+	Logger::GetMemoryLogger() = memoryLogger;
+}
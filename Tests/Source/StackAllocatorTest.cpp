@@ -111,4 +111,114 @@ TEST_CASE("StackAllocator Reallocation Test", "[Memory]") {
     REQUIRE(object2New->d == false);
     REQUIRE(object2New->e.size() == 6);
   }
-}
\ No newline at end of file
+}
+TEST_CASE("Page Backed StackAllocator Test", "[Memory]") {
+  StackAllocator stackAllocator =
+      StackAllocator("Stack Allocator", 16_MB, BackingPolicy::Pages);
+
+  // Nothing is committed before the stack grows into it
+  REQUIRE(stackAllocator.GetCommittedSize() == 0);
+
+  TestObject *object =
+      stackAllocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+  void *large = stackAllocator.Allocate(8_MB);
+  memset(large, 1, 8_MB);
+
+  REQUIRE(stackAllocator.GetCommittedSize() >= 8_MB);
+
+  stackAllocator.Deallocate(Size(large));
+
+  REQUIRE(stackAllocator.GetUsedSize() < 1_KB);
+  REQUIRE(stackAllocator.GetCommittedSize() <= 4_MB);
+  REQUIRE(object->a == 1);
+
+  stackAllocator.Delete(object);
+}
+
+TEST_CASE("StackAllocator Marker Test", "[Memory]") {
+  StackAllocator stackAllocator = StackAllocator("Stack Allocator", 10_MB);
+
+  TestObject *object =
+      stackAllocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+  const Size usedSize = stackAllocator.GetUsedSize();
+
+  SECTION("Free To Marker") {
+    const StackAllocator::Marker marker = stackAllocator.GetMarker();
+    for (int i = 0; i < 100; i++) {
+      stackAllocator.Allocate(64, 16);
+    }
+
+    stackAllocator.FreeToMarker(marker);
+    REQUIRE(stackAllocator.GetUsedSize() == usedSize);
+  }
+
+  SECTION("Nested Scopes") {
+    {
+      StackAllocatorScope outer(stackAllocator);
+      stackAllocator.Allocate(128);
+      const Size outerSize = stackAllocator.GetUsedSize();
+      {
+        StackAllocatorScope inner(stackAllocator);
+        stackAllocator.Allocate(1_KB);
+      }
+      REQUIRE(stackAllocator.GetUsedSize() == outerSize);
+    }
+    REQUIRE(stackAllocator.GetUsedSize() == usedSize);
+  }
+
+  REQUIRE(object->a == 1);
+
+  SECTION("Reset") {
+    stackAllocator.Allocate(1_KB);
+    const Size peakSize = stackAllocator.GetUsedSize();
+
+    stackAllocator.Reset();
+    REQUIRE(stackAllocator.GetUsedSize() == 0);
+    REQUIRE(stackAllocator.GetAllocatorData().LastPeakUsedSize == peakSize);
+    REQUIRE(stackAllocator.GetAllocatorData().PeakUsedSize == 0);
+  }
+}
+
+TEST_CASE("Double-Ended StackAllocator Test", "[Memory]") {
+  StackAllocator stackAllocator = StackAllocator("Stack Allocator", 1_MB);
+
+  SECTION("Both Ends") {
+    TestObject *object =
+        stackAllocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+    const Size bottomSize = stackAllocator.GetUsedSize();
+
+    {
+      StackAllocatorScope scope(stackAllocator, StackEnd::Top);
+      TestObject *temporary =
+          stackAllocator.NewTop<TestObject>(2, 2.1f, 'a', false, 10.6f);
+      void *aligned = stackAllocator.AllocateTop(100, 64);
+
+      REQUIRE((Size)aligned % 64 == 0);
+      REQUIRE((Size)aligned < (Size)temporary);
+      REQUIRE(stackAllocator.Contains(temporary));
+
+      // Freeing the bottom end leaves the top alone
+      TestObject *object2 =
+          stackAllocator.New<TestObject>(3, 2.1f, 'a', false, 10.6f);
+      stackAllocator.Delete(object2);
+      REQUIRE(temporary->a == 2);
+    }
+
+    REQUIRE(stackAllocator.GetUsedSize() == bottomSize);
+    REQUIRE(object->a == 1);
+    stackAllocator.Delete(object);
+  }
+
+  SECTION("Shared Budget") {
+    // Either end can take most of the buffer, as long as the other one leaves it room
+    void *bottom = stackAllocator.Allocate(600_KB);
+    REQUIRE(bottom != nullptr);
+    REQUIRE(stackAllocator.AllocateTop(600_KB) == nullptr);
+    REQUIRE(stackAllocator.AllocateTop(400_KB) != nullptr);
+    REQUIRE(stackAllocator.Allocate(100_KB) == nullptr);
+
+    stackAllocator.Reset();
+    REQUIRE(stackAllocator.AllocateTop(900_KB) != nullptr);
+    REQUIRE(stackAllocator.GetAllocatorData().LastPeakUsedSize >= 1000_KB);
+  }
+}
@@ -0,0 +1,102 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace QMBT;
+
+namespace
+{
+	constexpr int s_NumOperations = 20000;
+	constexpr int s_NumLiveBlocks = 64;
+
+	// The single lock design the thread cache replaces
+	class LockedFreeListAllocator
+	{
+	  public:
+		LockedFreeListAllocator(const char* debugName, const Size totalSize)
+			: m_Heap(debugName, totalSize, FreeListAllocator::FIND_SEGREGATED)
+		{
+		}
+
+		void* Allocate(const Size size)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_Heap.Allocate(size);
+		}
+
+		void Deallocate(void* ptr, const Size size)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Heap.Deallocate(ptr);
+		}
+
+	  private:
+		FreeListAllocator m_Heap;
+		std::mutex m_Mutex;
+	};
+
+	// Every thread keeps a small window of live blocks and replaces one of them per operation,
+	// the way short lived containers on worker threads use the global allocator
+	template <typename Allocator>
+	void Churn(Allocator& allocator, const int thread)
+	{
+		void* ptrs[s_NumLiveBlocks];
+		Size sizes[s_NumLiveBlocks];
+		for (int i = 0; i < s_NumLiveBlocks; i++)
+		{
+			sizes[i] = 16 + (i * 8) % 240;
+			ptrs[i] = allocator.Allocate(sizes[i]);
+		}
+
+		for (int i = 0; i < s_NumOperations; i++)
+		{
+			const int slot = (i * 7 + thread) % s_NumLiveBlocks;
+			allocator.Deallocate(ptrs[slot], sizes[slot]);
+			sizes[slot] = 16 + (i * 24 + thread * 8) % 240;
+			ptrs[slot] = allocator.Allocate(sizes[slot]);
+		}
+
+		for (int i = 0; i < s_NumLiveBlocks; i++)
+		{
+			allocator.Deallocate(ptrs[i], sizes[i]);
+		}
+	}
+
+	template <typename Allocator>
+	void BenchmarkThreads(Catch::Benchmark::Chronometer& meter, const int numThreads)
+	{
+		Allocator allocator("Benchmark Allocator", 64_MB);
+
+		meter.measure([&] {
+			std::vector<std::thread> threads;
+			for (int t = 0; t < numThreads; t++)
+			{
+				threads.emplace_back([&allocator, t] { Churn(allocator, t); });
+			}
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		});
+	}
+} // namespace
+
+// Every thread does the same amount of work, so flat timings mean linear scaling
+TEST_CASE("ThreadCachedAllocator Scaling Benchmark", "[Memory][!benchmark]")
+{
+	for (int numThreads : {1, 2, 4, 8})
+	{
+		const std::string threads = std::to_string(numThreads) + (numThreads == 1 ? " Thread" : " Threads");
+
+		BENCHMARK_ADVANCED("Locked, " + threads)(Catch::Benchmark::Chronometer meter)
+		{
+			BenchmarkThreads<LockedFreeListAllocator>(meter, numThreads);
+		};
+
+		BENCHMARK_ADVANCED("Thread Cached, " + threads)(Catch::Benchmark::Chronometer meter)
+		{
+			BenchmarkThreads<ThreadCachedAllocator>(meter, numThreads);
+		};
+	}
+}
@@ -0,0 +1,152 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+TEST_CASE("ThreadCachedAllocator Allocation Test", "[Memory]")
+{
+	ThreadCachedAllocator allocator = ThreadCachedAllocator("ThreadCached Allocator", 10_MB);
+
+	SECTION("Single Object")
+	{
+		TestObject* object = allocator.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+
+		REQUIRE(object->a == 1);
+		REQUIRE(object->b == 2.1f);
+		REQUIRE(object->c == 'a');
+		REQUIRE(object->d == false);
+		REQUIRE(object->e == 10.6f);
+
+		allocator.Delete(object);
+	}
+
+	SECTION("Alignment")
+	{
+		for (Size alignment = 8; alignment <= 256; alignment *= 2)
+		{
+			for (Size size : {1, 16, 100, 1024, 5000})
+			{
+				void* ptr = allocator.Allocate(size, alignment);
+				REQUIRE((Size)ptr % alignment == 0);
+				memset(ptr, 0xAB, size);
+				allocator.Deallocate(ptr, size);
+			}
+		}
+	}
+
+	SECTION("Reuse")
+	{
+		// A freed block stays in the thread cache and is handed out again for the same size class
+		void* ptr = allocator.Allocate(40);
+		allocator.Deallocate(ptr, 40);
+
+		void* reusedPtr = allocator.Allocate(48);
+		REQUIRE(reusedPtr == ptr);
+
+		allocator.Deallocate(reusedPtr, 48);
+	}
+
+	SECTION("Resize")
+	{
+		// Small blocks resize within their size class, large ones through the shared heap
+		void* small = allocator.Allocate(40);
+		REQUIRE(allocator.TryExpand(small, 40, 48));
+		REQUIRE_FALSE(allocator.TryExpand(small, 48, 2048));
+
+		UInt8* large = (UInt8*)allocator.Reallocate(small, 48, 2048);
+		memset(large, 3, 2048);
+		REQUIRE(allocator.TryExpand(large, 2048, 4096));
+		REQUIRE(large[2047] == 3);
+
+		allocator.Deallocate(large, 4096);
+	}
+
+	allocator.FlushThreadCache();
+	REQUIRE(allocator.GetUsedSize() == 0);
+}
+
+TEST_CASE("ThreadCachedAllocator Multithreaded Test", "[Memory]")
+{
+	ThreadCachedAllocator allocator = ThreadCachedAllocator("ThreadCached Allocator", 32_MB);
+
+	constexpr int numThreads = 4;
+	constexpr int numAllocations = 2000;
+
+	SECTION("Own Blocks")
+	{
+		// Catch assertions are not thread safe, so the threads only report whether their blocks were intact
+		std::atomic<bool> intact = true;
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < numThreads; t++)
+		{
+			threads.emplace_back([&allocator, &intact, t] {
+				std::vector<UInt8*> ptrs;
+				for (int round = 0; round < 5; round++)
+				{
+					for (int i = 0; i < numAllocations; i++)
+					{
+						const Size size = 8 + (i * 40) % 2000;
+						UInt8* ptr = (UInt8*)allocator.Allocate(size);
+						memset(ptr, t, size);
+						ptrs.push_back(ptr);
+					}
+
+					for (int i = 0; i < numAllocations; i++)
+					{
+						const Size size = 8 + (i * 40) % 2000;
+						if (ptrs[i][0] != t || ptrs[i][size - 1] != t)
+						{
+							intact = false;
+						}
+						allocator.Deallocate(ptrs[i], size);
+					}
+					ptrs.clear();
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		REQUIRE(intact);
+	}
+
+	SECTION("Blocks From Other Threads")
+	{
+		// Every thread frees the blocks allocated by the one before it
+		std::vector<std::vector<void*>> ptrs(numThreads);
+		for (int t = 0; t < numThreads; t++)
+		{
+			for (int i = 0; i < numAllocations; i++)
+			{
+				ptrs[t].push_back(allocator.Allocate(8 + (i * 24) % 500));
+			}
+		}
+		allocator.FlushThreadCache();
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < numThreads; t++)
+		{
+			threads.emplace_back([&allocator, &ptrs, t] {
+				const std::vector<void*>& otherPtrs = ptrs[(t + 1) % numThreads];
+				for (int i = 0; i < numAllocations; i++)
+				{
+					allocator.Deallocate(otherPtrs[i], 8 + (i * 24) % 500);
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	// Exiting threads give their cached blocks back
+	REQUIRE(allocator.GetUsedSize() == 0);
+}
@@ -0,0 +1,92 @@
+#include <Qombat/Tests.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "MemoryTestObjects.hpp"
+
+using namespace QMBT;
+
+TEST_CASE("VirtualArena Reservation Test", "[Memory]")
+{
+	// Far more than the application budget, but only what is committed counts against it
+	VirtualArena arena("Virtual Arena", 32_GB);
+	const Size totalAllocated = MemoryManager::GetInstance().GetTotalAllocatedSize();
+
+	REQUIRE(arena.GetReservedSize() == 32_GB);
+	REQUIRE(arena.GetCommittedSize() == 0);
+
+	SECTION("Growth")
+	{
+		// Pointers stay where they are while the arena commits past them
+		TestObject* object = arena.New<TestObject>(1, 2.1f, 'a', false, 10.6f);
+		REQUIRE(arena.GetCommittedSize() == VirtualArena::DEFAULT_COMMIT_SIZE);
+
+		UInt8* large = (UInt8*)arena.Allocate(100_MB, 64);
+		REQUIRE((Size)large % 64 == 0);
+		memset(large, 1, 100_MB);
+
+		REQUIRE(object->a == 1);
+		REQUIRE(object->e == 10.6f);
+		REQUIRE(large[100_MB - 1] == 1);
+		REQUIRE(arena.GetCommittedSize() >= 100_MB);
+		REQUIRE(MemoryManager::GetInstance().GetTotalAllocatedSize() == totalAllocated + arena.GetCommittedSize());
+	}
+
+	SECTION("Markers")
+	{
+		arena.Allocate(1_KB);
+		const VirtualArena::Marker marker = arena.GetMarker();
+		arena.Allocate(1_MB);
+
+		arena.FreeToMarker(marker);
+		REQUIRE(arena.GetUsedSize() == 1_KB);
+		REQUIRE(arena.GetCommittedSize() >= 1_MB);
+	}
+
+	SECTION("Reset")
+	{
+		arena.Allocate(10_MB);
+		arena.Reset();
+
+		REQUIRE(arena.GetUsedSize() == 0);
+		REQUIRE(arena.GetCommittedSize() == 0);
+		REQUIRE(arena.GetAllocatorData().LastPeakUsedSize == 10_MB);
+		REQUIRE(MemoryManager::GetInstance().GetTotalAllocatedSize() == totalAllocated);
+
+		// The pages are committed again on the next allocation
+		memset(arena.Allocate(1_MB), 1, 1_MB);
+	}
+}
+
+TEST_CASE("VirtualArena Exhaustion Test", "[Memory]")
+{
+	VirtualArena arena("Virtual Arena", 1_MB);
+
+	const bool logMemory = Logger::s_LogMemoryOn;
+	Logger::s_LogMemoryOn = false;
+
+	REQUIRE(arena.Allocate(768_KB) != nullptr);
+	REQUIRE(arena.Allocate(512_KB) == nullptr);
+	REQUIRE(arena.GetUsedSize() == 768_KB);
+
+	Logger::s_LogMemoryOn = logMemory;
+}
+
+TEST_CASE("VirtualArena Commit Size Test", "[Memory]")
+{
+	// A whole number of pages, but not a power of 2
+	VirtualArena arena("Virtual Arena", 1_MB, 100_KB);
+	REQUIRE(arena.GetReservedSize() >= 1_MB);
+	REQUIRE(arena.GetReservedSize() % 100_KB == 0);
+	REQUIRE(arena.GetReservedSize() < 1_MB + 100_KB);
+
+	arena.Allocate(1);
+	REQUIRE(arena.GetCommittedSize() == 100_KB);
+
+	// Every block up to the end of the allocation is committed, in steps of the commit size
+	UInt8* block = (UInt8*)arena.Allocate(150_KB);
+	memset(block, 1, 150_KB);
+	REQUIRE(arena.GetCommittedSize() == 200_KB);
+
+	arena.Allocate(arena.GetReservedSize() - arena.GetUsedSize());
+	REQUIRE(arena.GetCommittedSize() == arena.GetReservedSize());
+}